@@ -0,0 +1,267 @@
+#include <iostream>
+#include <algorithm>
+#include <ctime>
+
+#include "bar_aggregator.h"
+
+BarAggregator::BarAggregator(time_t period, time_t anchor, bool localTime)
+    : period(period > 0 ? period : 1), anchor(anchor), localTime(localTime) {}
+
+bool BarAggregator::addTick(const Tick& tick, Bar& completed) {
+    Bar bar {};
+    bar.symbol   = tick.symbol;
+    bar.date     = tick.time;
+    bar.open     = tick.price;
+    bar.high     = tick.price;
+    bar.low      = tick.price;
+    bar.close    = tick.price;
+    bar.adjClose = tick.price;
+    bar.vol      = tick.size;
+
+    return addBar(bar, completed);
+}
+
+bool BarAggregator::addBar(const Bar& bar, Bar& completed) {
+    bool closed = roll(bar.date, completed);
+
+    // Case A: First update of a new bucket
+    if (!hasCurrent) {
+        current = bar;
+        currentBucket = bucketStart(bar.date);
+        current.date = fromWallClock(currentBucket);
+        hasCurrent = true;
+    }
+
+    // Case B: Merge into the open bar
+    else {
+        current.high     = std::max(current.high, bar.high);
+        current.low      = std::min(current.low, bar.low);
+        current.close    = bar.close;
+        current.adjClose = bar.adjClose;
+        current.vol     += bar.vol;
+    }
+
+    return closed;
+}
+
+bool BarAggregator::roll(time_t now, Bar& completed) {
+    if (!hasCurrent || bucketStart(now) == currentBucket) {
+        return false;
+    }
+
+    finish(completed);
+    return true;
+}
+
+bool BarAggregator::flush(Bar& completed) {
+    if (!hasCurrent) {
+        return false;
+    }
+
+    finish(completed);
+    return true;
+}
+
+time_t BarAggregator::getPeriod() const {
+    return period;
+}
+
+time_t BarAggregator::bucketStart(time_t t) const {
+    // Floor towards negative infinity so dates before the anchor bucket correctly
+    time_t offset = toWallClock(t) - anchor;
+    time_t q = offset / period;
+    if (offset % period < 0) {
+        q--;
+    }
+    return anchor + q * period;
+}
+
+time_t BarAggregator::toWallClock(time_t t) const {
+    if (!localTime) {
+        return t;
+    }
+
+    std::tm local {};
+    localtime_r(&t, &local);
+    return t + local.tm_gmtoff;
+}
+
+time_t BarAggregator::fromWallClock(time_t wall) const {
+    if (!localTime) {
+        return wall;
+    }
+
+    // Read the wall-clock fields back as local time, letting mktime pick DST
+    std::tm local {};
+    gmtime_r(&wall, &local);
+    local.tm_isdst = -1;
+    return std::mktime(&local);
+}
+
+void BarAggregator::finish(Bar& completed) {
+    completed = current;
+    completed.returns = hasPrev ? (current.adjClose - prevAdjClose) / prevAdjClose : 0.0;
+
+    prevAdjClose = current.adjClose;
+    hasPrev = true;
+    hasCurrent = false;
+}
+
+TimeframeCascade::TimeframeCascade(std::vector<time_t> requested, time_t anchor, bool localTime) {
+    for (time_t period : requested) {
+        if (period <= 0) {
+            std::cerr << "Timeframe " << period << " is not positive, skipping" << std::endl;
+            continue;
+        }
+
+        // Compare with the last accepted level, not the requested list
+        if (!periods.empty() && (period <= periods.back() || period % periods.back() != 0)) {
+            std::cerr << "Timeframe " << period << " is not a multiple of "
+                      << periods.back() << ", skipping" << std::endl;
+            continue;
+        }
+
+        periods.push_back(period);
+        levels.emplace_back(period, anchor, localTime);
+    }
+}
+
+void TimeframeCascade::addTick(const Tick& tick, const BarCallback& onBar) {
+    if (levels.empty()) {
+        return;
+    }
+
+    Bar completed;
+    if (levels[0].addTick(tick, completed)) {
+        propagate(completed, tick.time, onBar);
+    }
+}
+
+void TimeframeCascade::addBar(const Bar& bar, const BarCallback& onBar) {
+    if (levels.empty()) {
+        return;
+    }
+
+    Bar completed;
+    if (levels[0].addBar(bar, completed)) {
+        propagate(completed, bar.date, onBar);
+    }
+}
+
+void TimeframeCascade::flush(const BarCallback& onBar) {
+    // Flush bottom-up so each partial bar reaches the level above first
+    for (size_t i = 0; i < levels.size(); i++) {
+        Bar completed;
+        if (!levels[i].flush(completed)) {
+            continue;
+        }
+
+        onBar(i, completed);
+
+        if (i + 1 < levels.size()) {
+            Bar ignored; // Same bucket as the level above, cannot close it
+            levels[i + 1].addBar(completed, ignored);
+        }
+    }
+}
+
+const std::vector<time_t>& TimeframeCascade::getPeriods() const {
+    return periods;
+}
+
+void TimeframeCascade::propagate(const Bar& completed, time_t now, const BarCallback& onBar) {
+    onBar(0, completed);
+
+    Bar finished = completed;
+    for (size_t i = 1; i < levels.size(); i++) {
+        Bar ignored;
+        levels[i].addBar(finished, ignored); // Same bucket as the open bar
+
+        // Close this level too if the new update is past its bucket
+        if (!levels[i].roll(now, finished)) {
+            break;
+        }
+        onBar(i, finished);
+    }
+}
+
+ResampledDataHandler::ResampledDataHandler(DataHandler* source, std::vector<time_t> periods,
+                                           time_t anchor, size_t maxHistory, bool localTime)
+    : source(source), symbolList(source->getSymbolList()), maxHistory(maxHistory > 0 ? maxHistory : 1) {
+    // Validate once and label levels by the periods actually built
+    TimeframeCascade prototype(periods, anchor, localTime);
+    this->periods = prototype.getPeriods();
+
+    for (const auto& s : symbolList) {
+        cascades.emplace(s, prototype);
+        resampledData[s].resize(this->periods.size());
+    }
+}
+
+std::vector<Bar> ResampledDataHandler::getLatestBars(std::string symbol, int N) {
+    return source->getLatestBars(symbol, N);
+}
+
+std::vector<Bar> ResampledDataHandler::getLatestBars(std::string symbol, time_t period, int N) {
+    auto it = resampledData.find(symbol);
+    auto level = std::find(periods.begin(), periods.end(), period);
+
+    if (it == resampledData.end() || level == periods.end()) {
+        std::cerr << "Timeframe not available" << std::endl;
+        return {};
+    }
+
+    const auto& bars = it->second[level - periods.begin()];
+
+    // If we have fewer than N bars, return all of them
+    if (bars.size() < static_cast<size_t>(N)) {
+        return std::vector<Bar>(bars.begin(), bars.end());
+    }
+
+    return std::vector<Bar>(bars.end() - N, bars.end());
+}
+
+void ResampledDataHandler::updateBars() {
+    source->updateBars();
+
+    bool newBarAdd = false;
+
+    for (const auto& s : symbolList) {
+        std::vector<Bar> latest = source->getLatestBars(s);
+
+        // Skip symbols without a new bar this step
+        if (latest.empty() || (lastSeen.count(s) && lastSeen[s] == latest[0].date)) {
+            continue;
+        }
+
+        lastSeen[s] = latest[0].date;
+        newBarAdd = true;
+
+        cascades.at(s).addBar(latest[0], [this, &s](size_t level, const Bar& bar) {
+            store(s, level, bar);
+        });
+    }
+
+    // End of data: publish the last partial bar of every timeframe
+    if (!newBarAdd && !flushed) {
+        for (const auto& s : symbolList) {
+            cascades.at(s).flush([this, &s](size_t level, const Bar& bar) {
+                store(s, level, bar);
+            });
+        }
+        flushed = true;
+    }
+}
+
+std::vector<std::string> ResampledDataHandler::getSymbolList() {
+    return symbolList;
+}
+
+void ResampledDataHandler::store(const std::string& symbol, size_t level, const Bar& bar) {
+    std::deque<Bar>& bars = resampledData[symbol][level];
+    bars.push_back(bar);
+
+    if (bars.size() > maxHistory) {
+        bars.pop_front();
+    }
+}
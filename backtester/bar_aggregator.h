@@ -0,0 +1,173 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <functional>
+#include <ctime>
+
+#include "data_handler.h"
+
+struct Tick {
+    std::string symbol;
+    time_t time;
+    double price;
+    long size;
+};
+
+class BarAggregator {
+    /*
+    Folds a stream of finer-grained updates (ticks or bars) into bars
+    of one fixed period. Buckets start at anchor plus a multiple of
+    the period, and only the bar currently being built is kept, i.e.
+    O(1) state.
+
+    Bucket arithmetic is done on wall-clock time: UTC, or with
+    localTime the local time zone (including DST) that std::mktime
+    used to stamp the dates, e.g. in HistoricCSVDataHandler. Otherwise
+    daily and weekly buckets would start at UTC midnight, which is not
+    midnight anywhere but UTC. Completed bars are dated with the
+    bucket start converted back to a time_t.
+
+    The epoch was a Thursday, so weekly bars need mondayAnchor (or
+    another weekday) to line up with trading weeks. Shorter periods
+    that divide a day are unaffected by a midnight anchor.
+    */
+
+public:
+    // 1970-01-05 00:00 wall-clock time, the first Monday after the epoch
+    static constexpr time_t mondayAnchor = 4 * 86400;
+
+    /*
+    Parameters:
+    period - Bar length in seconds, e.g. 60, 300, 3600, 86400, 604800.
+    anchor - Any wall-clock time at which a bucket starts, 0 for the epoch.
+    localTime - Buckets follow the local time zone instead of UTC.
+    */
+    explicit BarAggregator(time_t period, time_t anchor = 0, bool localTime = false);
+
+    /*
+    Merges the update into the current bar. If the update starts a
+    new bucket, the previous bar is written to completed and true is
+    returned.
+    */
+    bool addTick(const Tick& tick, Bar& completed);
+    bool addBar(const Bar& bar, Bar& completed);
+
+    // Completes the current bar if now lies in a later bucket
+    bool roll(time_t now, Bar& completed);
+
+    // Completes the current (partial) bar, e.g. at the end of the data
+    bool flush(Bar& completed);
+
+    time_t getPeriod() const;
+
+private:
+    time_t period;
+    time_t anchor;
+    bool localTime;
+    time_t currentBucket = 0; // Wall-clock start of the current bar's bucket
+    Bar current {};
+    bool hasCurrent = false;
+    double prevAdjClose = 0.0; // Last completed bar, for returns
+    bool hasPrev = false;
+
+    // Wall-clock bucket start of a time_t
+    time_t bucketStart(time_t t) const;
+
+    // Conversions between time_t and wall-clock seconds since the epoch
+    time_t toWallClock(time_t t) const;
+    time_t fromWallClock(time_t wall) const;
+
+    void finish(Bar& completed);
+};
+
+class TimeframeCascade {
+    /*
+    Builds several timeframes for one symbol in a single streaming
+    pass. Level 0 consumes the raw ticks or bars; each completed bar
+    at level i is merged into level i+1. Because every period is a
+    multiple of the one below it, a coarser bucket can only close
+    when a finer one does, so most updates touch level 0 only.
+    */
+
+public:
+    // Called for each completed bar with its level (index into periods)
+    using BarCallback = std::function<void(size_t level, const Bar& bar)>;
+
+    /*
+    Periods that are not a multiple of the last accepted one are
+    reported on std::cerr and left out, so level i is getPeriods()[i].
+
+    Parameters:
+    periods - Bar lengths in seconds, ascending, each a multiple of the previous.
+    anchor - Bucket alignment shared by all levels, see BarAggregator.
+    localTime - Buckets follow the local time zone instead of UTC.
+    */
+    explicit TimeframeCascade(std::vector<time_t> periods, time_t anchor = 0, bool localTime = false);
+
+    void addTick(const Tick& tick, const BarCallback& onBar);
+    void addBar(const Bar& bar, const BarCallback& onBar);
+
+    // Emits the partial bars of every level
+    void flush(const BarCallback& onBar);
+
+    // The accepted periods, one per level
+    const std::vector<time_t>& getPeriods() const;
+
+private:
+    std::vector<BarAggregator> levels;
+    std::vector<time_t> periods;
+
+    // Pushes a completed level-0 bar up through the coarser levels
+    void propagate(const Bar& completed, time_t now, const BarCallback& onBar);
+};
+
+class ResampledDataHandler : public DataHandler {
+    /*
+    ResampledDataHandler wraps another DataHandler and serves the
+    source bars together with any number of coarser timeframes built
+    on the fly from them, so strategies can look at e.g. daily and
+    weekly bars without separate pre-aggregated files.
+
+    The source keeps pushing MarketEvents onto its own queue; a bar
+    of a coarser timeframe becomes available once its bucket closes.
+    Only the most recent maxHistory bars of each timeframe are kept.
+    */
+
+public:
+    /*
+    Parameters:
+    source - The DataHandler providing the finest-grained bars.
+    periods - Coarser bar lengths in seconds, ascending, each a multiple of the previous.
+    anchor - Bucket alignment, e.g. BarAggregator::mondayAnchor for weekly bars.
+    maxHistory - Completed bars kept per symbol and timeframe.
+    localTime - Bucket in the local time zone, as HistoricCSVDataHandler
+                stamps its dates with std::mktime. Use false for UTC dates.
+    */
+    ResampledDataHandler(DataHandler* source, std::vector<time_t> periods,
+                         time_t anchor = 0, size_t maxHistory = 1000, bool localTime = true);
+
+    // Bars at the source resolution
+    std::vector<Bar> getLatestBars(std::string symbol, int N = 1) override;
+
+    // Completed bars of one of the configured periods
+    std::vector<Bar> getLatestBars(std::string symbol, time_t period, int N);
+
+    void updateBars() override;
+
+    std::vector<std::string> getSymbolList() override;
+
+private:
+    DataHandler* source;
+    std::vector<std::string> symbolList;
+    std::vector<time_t> periods; // Accepted by the cascade, indexed by level
+    size_t maxHistory;
+    std::map<std::string, TimeframeCascade> cascades;
+    std::map<std::string, std::vector<std::deque<Bar>>> resampledData; // symbol -> level -> bars
+    std::map<std::string, time_t> lastSeen; // Date of the last source bar consumed
+    bool flushed = false;
+
+    void store(const std::string& symbol, size_t level, const Bar& bar);
+};
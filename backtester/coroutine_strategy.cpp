@@ -0,0 +1,299 @@
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include "coroutine_strategy.h"
+
+namespace {
+
+// Every frame is prefixed with the pool it came from, so
+// operator delete can find it without the coroutine's arguments
+constexpr size_t frameHeader = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+static_assert(frameHeader >= sizeof(FramePool*));
+
+}
+
+void* FramePool::allocate(size_t size) {
+    size_t cls = (size + granularity - 1) / granularity - 1;
+
+    // Oversized frames go straight to the heap
+    if (cls >= numClasses) {
+        return ::operator new(size);
+    }
+
+    if (!freeLists[cls]) {
+        // Carve a new slab into frames of this class
+        size_t frameBytes = (cls + 1) * granularity;
+        slabs.push_back(std::make_unique<std::byte[]>(frameBytes * framesPerSlab));
+        std::byte* slab = slabs.back().get();
+
+        for (size_t i = 0; i < framesPerSlab; i++) {
+            auto* node = reinterpret_cast<FreeNode*>(slab + i * frameBytes);
+            node->next = freeLists[cls];
+            freeLists[cls] = node;
+        }
+    }
+
+    FreeNode* node = freeLists[cls];
+    freeLists[cls] = node->next;
+    return node;
+}
+
+void FramePool::deallocate(void* p, size_t size) {
+    size_t cls = (size + granularity - 1) / granularity - 1;
+
+    if (cls >= numClasses) {
+        ::operator delete(p);
+        return;
+    }
+
+    auto* node = static_cast<FreeNode*>(p);
+    node->next = freeLists[cls];
+    freeLists[cls] = node;
+}
+
+StrategyTask StrategyTask::promise_type::get_return_object() {
+    return StrategyTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+void* StrategyTask::promise_type::allocateFrame(size_t size, StrategyContext* ctx) {
+    FramePool* pool = (ctx && ctx->host) ? &ctx->host->pool : nullptr;
+    size_t total = size + frameHeader;
+
+    void* block = pool ? pool->allocate(total) : ::operator new(total);
+    *static_cast<FramePool**>(block) = pool;
+
+    return static_cast<std::byte*>(block) + frameHeader;
+}
+
+void StrategyTask::promise_type::operator delete(void* p, size_t size) {
+    void* block = static_cast<std::byte*>(p) - frameHeader;
+    FramePool* pool = *static_cast<FramePool**>(block);
+
+    if (pool) {
+        pool->deallocate(block, size + frameHeader);
+    }
+    else {
+        ::operator delete(block);
+    }
+}
+
+StrategyTask::StrategyTask(std::coroutine_handle<promise_type> handle)
+    : handle(handle) {}
+
+StrategyTask::StrategyTask(StrategyTask&& other) noexcept
+    : handle(std::exchange(other.handle, nullptr)) {}
+
+StrategyTask& StrategyTask::operator=(StrategyTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+StrategyTask::~StrategyTask() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+bool StrategyTask::done() const {
+    return !handle || handle.done();
+}
+
+void StrategyTask::resume() {
+    if (done()) {
+        return;
+    }
+
+    handle.resume();
+
+    // Surface exceptions thrown inside the strategy to the event loop
+    if (handle.done() && handle.promise().exception) {
+        std::rethrow_exception(handle.promise().exception);
+    }
+}
+
+void StrategyContext::BarAwaiter::await_suspend(std::coroutine_handle<>) {
+    CoroutineStrategy* host = ctx.host;
+    auto& waiters = host->barWaiters[ctx.symbolIndex];
+
+    // Nobody was tracking this symbol's bars, so its date may be stale
+    if (waiters.empty()) {
+        host->refreshBarDate(ctx.symbolIndex);
+    }
+    waiters.push_back(&ctx);
+}
+
+void StrategyContext::FillAwaiter::await_suspend(std::coroutine_handle<>) {
+    ctx.host->fillWaiters[ctx.symbolIndex].push_back(&ctx);
+}
+
+void StrategyContext::TimerAwaiter::await_suspend(std::coroutine_handle<>) {
+    CoroutineStrategy* host = ctx.host;
+    host->timers.push({host->barCount + bars, host->timerSequence++, &ctx});
+}
+
+std::vector<Bar> StrategyContext::latestBars(int N) {
+    return host->data->getLatestBars(symbol, N);
+}
+
+void StrategyContext::signal(SignalType signalType) {
+    std::vector<Bar> latest = latestBars(1);
+    time_t date = latest.empty() ? bar.date : latest[0].date;
+
+    host->events.push(std::make_shared<SignalEvent>(symbol, date, signalType));
+}
+
+std::ostream& StrategyContext::log() {
+    return *host->log;
+}
+
+CoroutineStrategy::CoroutineStrategy(DataHandler* data,
+                                     std::queue<std::shared_ptr<Event>>& events,
+                                     std::vector<std::string> symbolList,
+                                     StrategyBody body)
+    : data(data), events(events), symbolList(symbolList) {
+    barWaiters.resize(symbolList.size());
+    fillWaiters.resize(symbolList.size());
+    lastBarDate.resize(symbolList.size(), 0);
+    hasBar.resize(symbolList.size(), false);
+    dateCheckedAt.resize(symbolList.size(), UINT64_MAX);
+
+    for (size_t i = 0; i < symbolList.size(); i++) {
+        symbolIndex[symbolList[i]] = i;
+    }
+
+    for (const auto& s : symbolList) {
+        spawn(s, body);
+    }
+}
+
+CoroutineStrategy::~CoroutineStrategy() {
+    // Destroy the frames while the pool is still alive
+    contexts.clear();
+}
+
+void CoroutineStrategy::spawn(const std::string& symbol, const StrategyBody& body) {
+    auto it = symbolIndex.find(symbol);
+    if (it == symbolIndex.end()) {
+        std::cerr << "Symbol not available" << std::endl;
+        return;
+    }
+
+    // Reuse a finished coroutine's context before growing the deque
+    StrategyContext* slot = nullptr;
+    if (!freeContexts.empty()) {
+        slot = freeContexts.back();
+        freeContexts.pop_back();
+    }
+    else {
+        slot = &contexts.emplace_back();
+    }
+
+    StrategyContext& ctx = *slot;
+    ctx.symbol = symbol;
+    ctx.symbolIndex = it->second;
+    ctx.host = this;
+    ctx.body = body;
+    ctx.task = ctx.body(ctx);
+
+    active++;
+    resume(ctx); // Run up to the first co_await
+}
+
+void CoroutineStrategy::calculateSignals() {
+    barCount++;
+
+    // Wake coroutines waiting on a symbol that has a new bar
+    for (size_t k = 0; k < symbolList.size(); k++) {
+        if (barWaiters[k].empty()) {
+            continue;
+        }
+
+        std::vector<Bar> latest = data->getLatestBars(symbolList[k]);
+        dateCheckedAt[k] = barCount;
+
+        if (latest.empty() || (hasBar[k] && lastBarDate[k] == latest[0].date)) {
+            continue;
+        }
+        lastBarDate[k] = latest[0].date;
+        hasBar[k] = true;
+
+        // Swap out first: resumed coroutines may wait on the next bar again
+        ready.clear();
+        std::swap(ready, barWaiters[k]);
+
+        for (StrategyContext* ctx : ready) {
+            ctx->bar = latest[0];
+            resume(*ctx);
+        }
+    }
+
+    // Then expired timers, in the order they were set
+    while (!timers.empty() && timers.top().wakeAt <= barCount) {
+        StrategyContext* ctx = timers.top().ctx;
+        timers.pop();
+        resume(*ctx);
+    }
+}
+
+void CoroutineStrategy::updateFill(std::shared_ptr<FillEvent> fill) {
+    auto it = symbolIndex.find(fill->symbol);
+    if (it == symbolIndex.end()) {
+        return;
+    }
+
+    ready.clear();
+    std::swap(ready, fillWaiters[it->second]);
+
+    for (StrategyContext* ctx : ready) {
+        ctx->fill = fill;
+        resume(*ctx);
+    }
+}
+
+size_t CoroutineStrategy::getActiveCount() const {
+    return active;
+}
+
+void CoroutineStrategy::refreshBarDate(size_t k) {
+    if (dateCheckedAt[k] == barCount) {
+        return;
+    }
+    dateCheckedAt[k] = barCount;
+
+    std::vector<Bar> latest = data->getLatestBars(symbolList[k]);
+    if (!latest.empty()) {
+        lastBarDate[k] = latest[0].date;
+        hasBar[k] = true;
+    }
+}
+
+void CoroutineStrategy::resume(StrategyContext& ctx) {
+    ctx.task.resume();
+
+    if (ctx.task.done()) {
+        active--;
+        ctx.task = StrategyTask(); // Hand the frame back to the pool
+        ctx.body = nullptr;
+        ctx.bar = Bar {};
+        ctx.fill.reset();
+        freeContexts.push_back(&ctx);
+    }
+}
+
+StrategyTask buyAndHoldCoroutine(StrategyContext& ctx) {
+    /*
+    Equivalent of BuyAndHoldStrategy for one symbol: the position
+    in the coroutine replaces the boughtStatus map.
+    */
+
+    Bar bar = co_await ctx.nextBar();
+
+    ctx.signal(SignalType::LONG);
+    ctx.log() << "LONG " << ctx.symbol << " at " << bar.close << std::endl;
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <queue>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <coroutine>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+
+#include "event.h"
+#include "data_handler.h"
+#include "strategy.h"
+
+class CoroutineStrategy;
+struct StrategyContext;
+
+class FramePool {
+    /*
+    Fixed size-class allocator for coroutine frames. Freed frames go
+    onto a per-class free list and are reused, and fresh frames are
+    carved out of larger slabs, so spawning and finishing thousands of
+    strategy coroutines does not hit the global heap each time.
+    Not thread-safe: each pool belongs to one CoroutineStrategy.
+    */
+
+public:
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+
+private:
+    static constexpr size_t granularity = 64;
+    static constexpr size_t numClasses = 32;     // Pooled frames up to 2 KiB
+    static constexpr size_t framesPerSlab = 64;
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    FreeNode* freeLists[numClasses] = {};
+    std::vector<std::unique_ptr<std::byte[]>> slabs;
+};
+
+class StrategyTask {
+    /*
+    Return type of a strategy coroutine. The coroutine starts
+    suspended and is driven by its CoroutineStrategy. Frames are
+    allocated from the pool of the CoroutineStrategy whose
+    StrategyContext is passed to the coroutine.
+    */
+
+public:
+    struct promise_type {
+        std::exception_ptr exception;
+
+        StrategyTask get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        // Picks the StrategyContext out of the coroutine's arguments
+        template <typename... Args>
+        static void* operator new(size_t size, Args&... args) {
+            StrategyContext* ctx = nullptr;
+            ((ctx = pick(args, ctx)), ...);
+            return allocateFrame(size, ctx);
+        }
+
+        static void* operator new(size_t size) {
+            return allocateFrame(size, nullptr);
+        }
+
+        static void operator delete(void* p, size_t size);
+
+    private:
+        static StrategyContext* pick(StrategyContext& ctx, StrategyContext*) { return &ctx; }
+
+        template <typename T>
+        static StrategyContext* pick(T&, StrategyContext* prev) { return prev; }
+
+        static void* allocateFrame(size_t size, StrategyContext* ctx);
+    };
+
+    StrategyTask() = default;
+    explicit StrategyTask(std::coroutine_handle<promise_type> handle);
+    StrategyTask(StrategyTask&& other) noexcept;
+    StrategyTask& operator=(StrategyTask&& other) noexcept;
+    ~StrategyTask();
+
+    bool done() const;
+    void resume();
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct StrategyContext {
+    /*
+    The handle a strategy coroutine uses to talk to the engine:
+    await market data, fills or timers and emit signals for its
+    symbol. Owned by the CoroutineStrategy running the coroutine.
+    */
+
+    std::string symbol;
+    size_t symbolIndex;
+    CoroutineStrategy* host;
+
+    // Resumes with the symbol's next bar
+    struct BarAwaiter {
+        StrategyContext& ctx;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h);
+        Bar await_resume() const { return ctx.bar; }
+    };
+
+    // Resumes with the next fill for the symbol
+    struct FillAwaiter {
+        StrategyContext& ctx;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h);
+        std::shared_ptr<FillEvent> await_resume() const { return ctx.fill; }
+    };
+
+    // Resumes after the given number of market events
+    struct TimerAwaiter {
+        StrategyContext& ctx;
+        uint64_t bars;
+        bool await_ready() const noexcept { return bars == 0; }
+        void await_suspend(std::coroutine_handle<> h);
+        void await_resume() const {}
+    };
+
+    BarAwaiter nextBar() { return {*this}; }
+    FillAwaiter nextFill() { return {*this}; }
+    TimerAwaiter sleepBars(uint64_t bars) { return {*this, bars}; }
+
+    // Last N bars of the symbol, as DataHandler::getLatestBars
+    std::vector<Bar> latestBars(int N = 1);
+
+    // Pushes a SignalEvent for the symbol at the latest bar's date
+    void signal(SignalType signalType);
+
+    // Where the host Strategy writes its messages (see Strategy::setLog)
+    std::ostream& log();
+
+    // Filled in by the host before resuming
+    Bar bar {};
+    std::shared_ptr<FillEvent> fill;
+
+    // The body is kept alive (and declared first, so destroyed last)
+    // because a lambda coroutine's captures live in the lambda object
+    std::function<StrategyTask(StrategyContext&)> body;
+    StrategyTask task;
+};
+
+class CoroutineStrategy : public Strategy {
+    /*
+    CoroutineStrategy hosts many lightweight strategy coroutines, by
+    default one per symbol. Each coroutine is written as straight-line
+    code that co_awaits the next bar, a fill or a timer, instead of a
+    hand-rolled state machine in member variables.
+
+    On every MarketEvent only the coroutines waiting on a symbol that
+    received a new bar (or on an expired timer) are resumed, so the
+    per-event cost is one virtual call for the whole population.
+    Contexts of finished coroutines are kept on a free list and reused
+    by spawn, so memory stays bounded by the peak number of live ones.
+    */
+
+public:
+    using StrategyBody = std::function<StrategyTask(StrategyContext&)>;
+
+    /*
+    Parameters:
+    data - The DataHandler object that provides bar information.
+    events - The Event Queue object.
+    symbolList - One coroutine is spawned for each symbol.
+    body - Creates the coroutine for a symbol's context.
+    */
+    CoroutineStrategy(DataHandler* data,
+                      std::queue<std::shared_ptr<Event>>& events,
+                      std::vector<std::string> symbolList,
+                      StrategyBody body);
+    ~CoroutineStrategy() override;
+
+    CoroutineStrategy(const CoroutineStrategy&) = delete;
+    CoroutineStrategy& operator=(const CoroutineStrategy&) = delete;
+
+    // Starts an additional coroutine for a symbol, runs it to its first co_await
+    void spawn(const std::string& symbol, const StrategyBody& body);
+
+    void calculateSignals() override;
+
+    // Resumes the coroutines waiting on a fill for its symbol
+    void updateFill(std::shared_ptr<FillEvent> fill) override;
+
+    // Coroutines that have not yet finished
+    size_t getActiveCount() const;
+
+private:
+    friend struct StrategyContext;
+    friend struct StrategyTask::promise_type;
+
+    struct Timer {
+        uint64_t wakeAt;
+        uint64_t sequence;
+        StrategyContext* ctx;
+
+        bool operator>(const Timer& other) const {
+            return wakeAt != other.wakeAt ? wakeAt > other.wakeAt : sequence > other.sequence;
+        }
+    };
+
+    DataHandler* data;
+    std::queue<std::shared_ptr<Event>>& events;
+    std::vector<std::string> symbolList;
+    std::map<std::string, size_t> symbolIndex;
+
+    FramePool pool; // Declared before contexts so it outlives their frames
+    std::deque<StrategyContext> contexts;
+    std::vector<StrategyContext*> freeContexts; // Finished, ready for reuse by spawn
+    size_t active = 0;
+
+    std::vector<std::vector<StrategyContext*>> barWaiters;  // Per symbol index
+    std::vector<std::vector<StrategyContext*>> fillWaiters; // Per symbol index
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::vector<time_t> lastBarDate;
+    std::vector<bool> hasBar;
+    std::vector<uint64_t> dateCheckedAt; // barCount when lastBarDate was last refreshed
+    std::vector<StrategyContext*> ready; // Scratch list of coroutines to resume
+    uint64_t barCount = 0;
+    uint64_t timerSequence = 0;
+
+    void resume(StrategyContext& ctx);
+
+    // Brings lastBarDate up to date so a new waiter only sees later bars
+    void refreshBarDate(size_t k);
+};
+
+// BuyAndHoldStrategy as a coroutine: wait for the first bar, go long, done
+StrategyTask buyAndHoldCoroutine(StrategyContext& ctx);
@@ -20,12 +20,14 @@ HistoricCSVDataHandler::HistoricCSVDataHandler(std::queue<std::shared_ptr<Event>
 }
 
 std::vector<Bar> HistoricCSVDataHandler::getLatestBars(std::string symbol, int N) {
-    // Check if symbol exists
-    if (latestSymbolData.find(symbol) == latestSymbolData.end()) {
+    // Check if symbol exists (find only, so concurrent readers never insert)
+    auto it = latestSymbolData.find(symbol);
+    if (it == latestSymbolData.end()) {
         std::cerr << "Symbol not available" << std::endl;
+        return {};
     }
 
-    const auto &bars = latestSymbolData[symbol];
+    const auto &bars = it->second;
 
     // If we have fewer than N bars, return N
     if (bars.size() < static_cast<size_t>(N)) {
@@ -180,4 +182,8 @@ void HistoricCSVDataHandler::alignAndPadData(const std::string& symbol, std::map
 
 std::vector<std::string> HistoricCSVDataHandler::getSymbolList() {
     return symbolList;
-}
\ No newline at end of file
+}
+
+const std::map<std::string, std::vector<Bar>>& HistoricCSVDataHandler::getSymbolData() const {
+    return symbolData;
+}
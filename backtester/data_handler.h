@@ -73,6 +73,9 @@ public:
     void updateBars() override;
 
     std::vector<std::string> getSymbolList() override;
+
+    // Full aligned and padded history, e.g. for publishing or vectorised runs
+    const std::map<std::string, std::vector<Bar>>& getSymbolData() const;
     
 private:
     std::queue<std::shared_ptr<Event>> &events;
@@ -16,8 +16,8 @@ EventType SignalEvent::getEventType() const {
 
 // OrderEvent instantiated
 OrderEvent::OrderEvent(const std::string &symbol, OrderType orderType,
-                       unsigned long quantity, DirectionType direction)
-    : symbol(symbol), orderType(orderType), quantity(quantity), direction(direction) {}
+                       unsigned long quantity, DirectionType direction, double price)
+    : symbol(symbol), orderType(orderType), quantity(quantity), direction(direction), price(price) {}
 EventType OrderEvent::getEventType() const {
     return EventType::ORDER;
 }
@@ -31,10 +31,6 @@ double FillEvent::calcCommission(unsigned long quantity, long double fillCost) {
     Source: https://www.interactivebrokers.com/en/pricing/commissions-stocks.php
     */
 
-    double commPerShare = 0.005;
-    double minComm = 1.00;
-    double maxPercent = 1.0;
-
     double baseComm = std::max(minComm, commPerShare * quantity);
 
     double tradeVal = quantity * fillCost;
@@ -13,12 +13,14 @@ enum class EventType {
 
 enum class SignalType {
     LONG,
-    SHORT
+    SHORT,
+    EXIT
 };
 
 enum class OrderType {
     MKT,
-    LMT
+    LMT,
+    STP
 };
 
 enum class DirectionType {
@@ -60,7 +62,7 @@ public:
     Parameters:
     symbol - The ticker symbol, e.g. 'GOOG'.
     datetime - The timestamp at which the signal was generated.
-    signalType - 'LONG' or 'SHORT'.
+    signalType - 'LONG', 'SHORT' or 'EXIT'.
     */
 
     SignalEvent(const std::string &symbol, time_t datetime, SignalType signalType);
@@ -82,18 +84,20 @@ public:
     /*
     Parameters:
     symbol - The instrument to trade.
-    order_type - 'MKT' or 'LMT' for Market or Limit.
+    order_type - 'MKT', 'LMT' or 'STP' for Market, Limit or Stop.
     quantity - Non-negative integer for quantity.
     direction - 'BUY' or 'SELL' for long or short.
+    price - The limit or stop price (ignored for market orders).
     */
     OrderEvent(const std::string &symbol, OrderType orderType, unsigned long quantity,
-               DirectionType direction);
+               DirectionType direction, double price = 0.0);
     EventType getEventType() const override;
 
     std::string symbol;
     OrderType orderType;
     unsigned long quantity;
     DirectionType direction;
+    double price;
 };
 
 class FillEvent : public Event {
@@ -126,6 +130,11 @@ public:
 
     static double calcCommission(unsigned long quantity, long double fillCost);
 
+    // Interactive Brokers 'Fixed' pricing, also used by the vectorised engine
+    static constexpr double commPerShare = 0.005;
+    static constexpr double minComm = 1.00;
+    static constexpr double maxPercent = 1.0;
+
     time_t timeIndex;
     std::string symbol;
     std::string exchange;
@@ -0,0 +1,274 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "execution.h"
+
+IntrabarExecutionHandler::IntrabarExecutionHandler(DataHandler* bars,
+                                                   std::queue<std::shared_ptr<Event>>& events,
+                                                   IntrabarPath path,
+                                                   int bridgeSteps,
+                                                   uint64_t seed)
+    : bars(bars), events(events), path(path),
+      bridgeSteps(std::max(1, bridgeSteps)), rng(seed) {}
+
+void IntrabarExecutionHandler::executeOrder(std::shared_ptr<OrderEvent> event) {
+    // Market orders fill straight away at the latest close
+    if (event->orderType == OrderType::MKT) {
+        std::vector<Bar> latest = bars->getLatestBars(event->symbol);
+        if (latest.empty()) {
+            std::cerr << "No market data to fill " << event->symbol << std::endl;
+            return;
+        }
+
+        events.push(std::make_shared<FillEvent>(latest[0].date, event->symbol, "ARCA",
+                                                event->quantity, event->direction, latest[0].close));
+        return;
+    }
+
+    // Limit and stop orders rest until a later bar touches their price
+    bool buy = event->direction == DirectionType::BUY;
+    bool stop = event->orderType == OrderType::STP;
+
+    RestingOrders& orders = resting[event->symbol];
+
+    // The bar the order was placed on must not be scanned for it
+    std::vector<Bar> latest = bars->getLatestBars(event->symbol);
+    if (!latest.empty()) {
+        orders.lastBar = latest[0].date;
+        orders.scanned = true;
+    }
+
+    orders.price.push_back(event->price);
+    orders.above.push_back(buy == stop); // Sell limits and buy stops trigger on the way up
+    orders.buy.push_back(buy);
+    orders.quantity.push_back(event->quantity);
+    orders.sequence.push_back(nextSequence++);
+}
+
+void IntrabarExecutionHandler::updateBars() {
+    for (auto& [symbol, orders] : resting) {
+        if (orders.price.empty()) {
+            continue;
+        }
+
+        std::vector<Bar> latest = bars->getLatestBars(symbol);
+        if (latest.empty()) {
+            continue;
+        }
+
+        // Each bar is only scanned once, even if the symbol's data has ended
+        const Bar& bar = latest[0];
+        if (orders.scanned && orders.lastBar == bar.date) {
+            continue;
+        }
+        orders.lastBar = bar.date;
+        orders.scanned = true;
+
+        buildPath(bar);
+        scan(orders, bar.open);
+        fillTouched(symbol, orders, bar.date);
+    }
+}
+
+size_t IntrabarExecutionHandler::getRestingCount() const {
+    size_t count = 0;
+    for (const auto& [symbol, orders] : resting) {
+        count += orders.price.size();
+    }
+    return count;
+}
+
+void IntrabarExecutionHandler::buildPath(const Bar& bar) {
+    waypoints.clear();
+    waypoints.push_back(bar.open);
+
+    bool highFirst = true;
+
+    switch (path) {
+        case IntrabarPath::OHLC:
+            highFirst = true;
+            break;
+        case IntrabarPath::OLHC:
+            highFirst = false;
+            break;
+        case IntrabarPath::NEAREST:
+            highFirst = (bar.high - bar.open) <= (bar.open - bar.low);
+            break;
+        case IntrabarPath::BROWNIAN_BRIDGE:
+            highFirst = std::bernoulli_distribution(0.5)(rng);
+            break;
+    }
+
+    double first = highFirst ? bar.high : bar.low;
+    double second = highFirst ? bar.low : bar.high;
+
+    if (path == IntrabarPath::BROWNIAN_BRIDGE) {
+        appendBridge(bar.open, first, bar.low, bar.high);
+        appendBridge(first, second, bar.low, bar.high);
+        appendBridge(second, bar.close, bar.low, bar.high);
+    }
+    else {
+        waypoints.push_back(first);
+        waypoints.push_back(second);
+        waypoints.push_back(bar.close);
+    }
+
+    // Running extremes: an order is touched by waypoint j if the
+    // path up to j has reached its price. The first half holds the
+    // running max, the second the negated running min, so both are
+    // non-decreasing and searched the same way.
+    const size_t w = waypoints.size();
+    reach.resize(2 * w);
+    reach[0] = waypoints[0];
+    reach[w] = -waypoints[0];
+
+    for (size_t j = 1; j < w; j++) {
+        reach[j] = std::max(reach[j - 1], waypoints[j]);
+        reach[w + j] = std::max(reach[w + j - 1], -waypoints[j]);
+    }
+}
+
+void IntrabarExecutionHandler::appendBridge(double from, double to, double low, double high) {
+    // Brownian bridge pinned at both ends, scaled to the bar's range
+    std::normal_distribution<double> step(0.0, 1.0 / std::sqrt(static_cast<double>(bridgeSteps)));
+    double sigma = 0.5 * (high - low);
+
+    std::vector<double> walk(bridgeSteps + 1, 0.0);
+    for (int k = 1; k <= bridgeSteps; k++) {
+        walk[k] = walk[k - 1] + step(rng);
+    }
+
+    for (int k = 1; k <= bridgeSteps; k++) {
+        double t = static_cast<double>(k) / bridgeSteps;
+        double bridge = walk[k] - t * walk[bridgeSteps];
+        double price = from + t * (to - from) + sigma * bridge;
+
+        waypoints.push_back(std::clamp(price, low, high));
+    }
+}
+
+void IntrabarExecutionHandler::scan(RestingOrders& orders, double open) {
+    const size_t n = orders.price.size();
+    const int32_t untouched = static_cast<int32_t>(waypoints.size());
+
+    orders.touch.resize(n);
+    orders.fillPrice.resize(n);
+
+    if (untouched == fixedPathLength) {
+        scanFixedPath(orders, open);
+        return;
+    }
+
+    const double* price = orders.price.data();
+    const uint8_t* above = orders.above.data();
+    int32_t* touch = orders.touch.data();
+    double* fillPrice = orders.fillPrice.data();
+
+    // One pass over the orders. The first touch is the lower bound of
+    // the order's price in its (monotone) half of reach, found by a
+    // binary search whose steps depend only on the path length. The
+    // comparisons are used as 0/1 offsets rather than branches, since
+    // whether an order is touched is unpredictable.
+    for (size_t i = 0; i < n; i++) {
+        const int32_t down = 1 - above[i];
+        const double* first = reach.data() + down * untouched;
+        const double key = price[i] * (1.0 - 2.0 * down);
+
+        const double* base = first;
+        for (int32_t len = untouched; len > 1; len -= len / 2) {
+            base += (base[len / 2 - 1] < key) * (len / 2);
+        }
+
+        const int32_t t = static_cast<int32_t>(base - first) + (*base < key);
+        touch[i] = t;
+
+        // Touched at the open means the bar gapped through the price
+        const double candidates[2] = {open, price[i]};
+        fillPrice[i] = candidates[t != 0];
+    }
+}
+
+void IntrabarExecutionHandler::scanFixedPath(RestingOrders& orders, double open) {
+    const size_t n = orders.price.size();
+
+    const double* price = orders.price.data();
+    const uint8_t* above = orders.above.data();
+    int32_t* touch = orders.touch.data();
+    double* fillPrice = orders.fillPrice.data();
+
+    // Running max and min after each of the four waypoints
+    const double hi0 = reach[0], hi1 = reach[1], hi2 = reach[2], hi3 = reach[3];
+    const double lo0 = -reach[4], lo1 = -reach[5], lo2 = -reach[6], lo3 = -reach[7];
+
+    // As the extremes are monotone, the first touch is the number of
+    // waypoints that have not reached the price yet. Counted without
+    // branches over doubles, this loop vectorises across orders
+    // (GCC 12 at -O3).
+    for (size_t i = 0; i < n; i++) {
+        const double p = price[i];
+        const double up = above[i];
+
+        const double missedUp = static_cast<double>(hi0 < p) + static_cast<double>(hi1 < p) +
+                                static_cast<double>(hi2 < p) + static_cast<double>(hi3 < p);
+        const double missedDown = static_cast<double>(lo0 > p) + static_cast<double>(lo1 > p) +
+                                  static_cast<double>(lo2 > p) + static_cast<double>(lo3 > p);
+        const double t = up * missedUp + (1.0 - up) * missedDown;
+
+        touch[i] = static_cast<int32_t>(t);
+
+        // Touched at the open means the bar gapped through the price
+        fillPrice[i] = t == 0.0 ? open : p;
+    }
+}
+
+void IntrabarExecutionHandler::fillTouched(const std::string& symbol, RestingOrders& orders, time_t date) {
+    const size_t n = orders.price.size();
+    const int32_t untouched = static_cast<int32_t>(waypoints.size());
+
+    std::vector<size_t> filled;
+    for (size_t i = 0; i < n; i++) {
+        if (orders.touch[i] < untouched) {
+            filled.push_back(i);
+        }
+    }
+
+    if (filled.empty()) {
+        return;
+    }
+
+    // Fills go out in the order the path touched them, then by submission
+    std::sort(filled.begin(), filled.end(), [&orders](size_t a, size_t b) {
+        if (orders.touch[a] != orders.touch[b]) {
+            return orders.touch[a] < orders.touch[b];
+        }
+        return orders.sequence[a] < orders.sequence[b];
+    });
+
+    for (size_t i : filled) {
+        DirectionType direction = orders.buy[i] ? DirectionType::BUY : DirectionType::SELL;
+        events.push(std::make_shared<FillEvent>(date, symbol, "ARCA", orders.quantity[i],
+                                                direction, orders.fillPrice[i]));
+    }
+
+    // Compact the remaining orders, keeping submission order
+    size_t keep = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (orders.touch[i] < untouched) {
+            continue;
+        }
+
+        orders.price[keep]    = orders.price[i];
+        orders.above[keep]    = orders.above[i];
+        orders.buy[keep]      = orders.buy[i];
+        orders.quantity[keep] = orders.quantity[i];
+        orders.sequence[keep] = orders.sequence[i];
+        keep++;
+    }
+
+    orders.price.resize(keep);
+    orders.above.resize(keep);
+    orders.buy.resize(keep);
+    orders.quantity.resize(keep);
+    orders.sequence.resize(keep);
+}
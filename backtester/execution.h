@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <queue>
+#include <memory>
+#include <random>
+#include <cstdint>
+
+#include "event.h"
+#include "data_handler.h"
+
+class ExecutionHandler {
+    /*
+    The ExecutionHandler abstract class handles the interaction
+    between a set of order objects generated by a Portfolio and
+    the ultimate set of Fill objects that actually occur in the
+    market.
+
+    The handlers can be used to subclass simulated brokerages
+    or live brokerages, with identical interfaces.
+    */
+
+public:
+    virtual ~ExecutionHandler() = default;
+
+    /*
+    Takes an OrderEvent and executes it, producing
+    a FillEvent that gets placed onto the Events queue.
+    */
+    virtual void executeOrder(std::shared_ptr<OrderEvent> event) = 0;
+};
+
+enum class IntrabarPath {
+    OHLC,           // Open -> High -> Low -> Close
+    OLHC,           // Open -> Low -> High -> Close
+    NEAREST,        // Visit whichever extreme is closer to the open first
+    BROWNIAN_BRIDGE // Sampled bridge through the extremes, clamped to [low, high]
+};
+
+class IntrabarExecutionHandler : public ExecutionHandler {
+    /*
+    IntrabarExecutionHandler simulates fills inside each bar. Market
+    orders fill immediately at the latest close. Limit and stop orders
+    rest until the modelled price path of a later bar touches their
+    price, at which point they fill at that price (or at the open if
+    the bar gaps through it).
+
+    Resting orders are stored per symbol as parallel arrays. Since the
+    running high and low of the path only ever widen, each new bar
+    finds every order's first touch in a single branch-free pass over
+    those arrays: for the four-waypoint OHLC, OLHC and NEAREST paths
+    by counting the extremes that fall short of the price (a loop the
+    compiler vectorises), and for BROWNIAN_BRIDGE paths by a binary
+    search.
+    */
+
+public:
+    /*
+    Parameters:
+    bars - The DataHandler object with current market data.
+    events - The Event Queue object.
+    path - How the price moves between open, high, low and close.
+    bridgeSteps - Samples per leg for BROWNIAN_BRIDGE paths.
+    seed - Seed of the bridge sampler, so runs are reproducible.
+    */
+    IntrabarExecutionHandler(DataHandler* bars,
+                             std::queue<std::shared_ptr<Event>>& events,
+                             IntrabarPath path = IntrabarPath::OHLC,
+                             int bridgeSteps = 8,
+                             uint64_t seed = 42);
+
+    void executeOrder(std::shared_ptr<OrderEvent> event) override;
+
+    /*
+    Checks every resting order against the latest bar of its symbol
+    and pushes a FillEvent for each one touched, in the order they
+    were touched. Call on each MarketEvent, before the Strategy runs,
+    so an order is never checked against the bar it was placed on.
+    */
+    void updateBars();
+
+    // Number of limit/stop orders still waiting for a fill
+    size_t getRestingCount() const;
+
+private:
+    // Structure-of-arrays storage of one symbol's resting orders
+    struct RestingOrders {
+        std::vector<double> price;
+        std::vector<uint8_t> above;      // 1: fills when price rises to it, 0: when it falls to it
+        std::vector<uint8_t> buy;
+        std::vector<unsigned long> quantity;
+        std::vector<uint64_t> sequence;  // Submission order, to break ties
+
+        // Scratch results of the per-bar scan
+        std::vector<int32_t> touch;      // Waypoint index of the first touch, or the path length if untouched
+        std::vector<double> fillPrice;
+
+        time_t lastBar = 0;
+        bool scanned = false;
+    };
+
+    DataHandler* bars;
+    std::queue<std::shared_ptr<Event>>& events;
+    IntrabarPath path;
+    int bridgeSteps;
+    std::mt19937_64 rng;
+    std::map<std::string, RestingOrders> resting;
+    uint64_t nextSequence = 0;
+
+    // Scratch path of the current bar and its running extremes
+    std::vector<double> waypoints;
+    std::vector<double> reach; // Running max, then negated running min
+
+    void buildPath(const Bar& bar);
+    void appendBridge(double from, double to, double low, double high);
+
+    // Open, high/low, low/high, close
+    static constexpr int32_t fixedPathLength = 4;
+
+    // Finds the first touch of every order in one pass
+    void scan(RestingOrders& orders, double open);
+    void scanFixedPath(RestingOrders& orders, double open);
+
+    // Emits fills in touch order and compacts the unfilled orders
+    void fillTouched(const std::string& symbol, RestingOrders& orders, time_t date);
+};
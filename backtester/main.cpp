@@ -7,14 +7,64 @@
 #include "event.h"
 #include "data_handler.h"
 #include "strategy.h"
+#include "sharded_engine.h"
+#include "vectorized_backtest.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     // Create event queue for communication with the system
     std::queue<std::shared_ptr<Event>> events;
 
     // Define file directory and dummy file
     std::string csvDir = "symbol_data";
     std::vector<std::string> symbolList = {"AAPL"};
+
+    // Optional "--verify" checks the vectorised engine against the event loop
+    // on a small synthetic fixture whose signals do trade
+    if (argc > 1 && std::string(argv[1]) == "--verify") {
+        std::string verifyDir = "symbol_data/verify";
+        std::vector<std::string> verifySymbols = {"AAA", "BBB", "CCC"};
+
+        // Long on three rising closes, short on three falling ones, else flat
+        SignalFunction flip = [](const BarColumns& bars, std::vector<int>& target) {
+            target.assign(bars.close.size(), 0);
+            for (size_t t = 3; t < target.size(); t++) {
+                bool up = bars.close[t] > bars.close[t - 1] && bars.close[t - 1] > bars.close[t - 2];
+                bool down = bars.close[t] < bars.close[t - 1] && bars.close[t - 1] < bars.close[t - 2];
+                target[t] = up ? 1 : down ? -1 : 0;
+            }
+        };
+
+        std::vector<std::pair<std::string, SignalFunction>> signals = {
+            {"MA 2/5", movingAverageCross(2, 5)},
+            {"MA 3/10", movingAverageCross(3, 10)},
+            {"MA 5/20", movingAverageCross(5, 20)},
+            {"LONG/SHORT/EXIT flip", flip},
+        };
+
+        std::queue<std::shared_ptr<Event>> unused;
+        HistoricCSVDataHandler fixture(unused, verifyDir, verifySymbols);
+
+        bool allIdentical = true;
+        for (const auto& [name, signal] : signals) {
+            bool identical = verifyAgainstEventDriven(verifyDir, verifySymbols, signal);
+            VectorizedResult result = VectorizedBacktest(fixture, verifySymbols, signal).run();
+            double commission = result.commission.empty() ? 0.0 : result.commission.back();
+
+            std::cout << name << ": " << (identical ? "matches" : "DIFFERS")
+                      << " (commission paid " << commission << ")" << std::endl;
+            allIdentical = allIdentical && identical && commission > 0.0;
+        }
+
+        std::cout << (allIdentical ? "Vectorised backtest matches event-driven run"
+                                   : "Vectorised backtest differs from event-driven run") << std::endl;
+        return allIdentical ? 0 : 1;
+    }
+
+    // Optional "--shards N" runs strategies on N worker threads
+    unsigned numShards = 1;
+    if (argc > 2 && std::string(argv[1]) == "--shards") {
+        numShards = static_cast<unsigned>(std::stoul(argv[2]));
+    }
     
     std::cout << "-----Starting Data Handler-----" << std::endl;
 
@@ -22,7 +72,22 @@ int main() {
     HistoricCSVDataHandler dataHandler(events, csvDir, symbolList);
 
     std::cout << "-----Initialising Strategy-----" << std::endl;
-    BuyAndHoldStrategy strategy(&dataHandler, events, symbolList);
+
+    // Either one serial strategy, or one per shard over its subset of symbols
+    std::unique_ptr<BuyAndHoldStrategy> strategy;
+    std::unique_ptr<ShardedEventEngine> engine;
+    if (numShards <= 1) {
+        strategy = std::make_unique<BuyAndHoldStrategy>(&dataHandler, events, symbolList);
+    }
+    else {
+        engine = std::make_unique<ShardedEventEngine>(
+            &dataHandler, events,
+            [](DataHandler* data, std::queue<std::shared_ptr<Event>>& q, std::vector<std::string> symbols) {
+                return std::make_unique<BuyAndHoldStrategy>(data, q, symbols);
+            },
+            numShards);
+        std::cout << "Running " << engine->getNumShards() << " shard(s)" << std::endl;
+    }
 
     std::cout << "-----Starting Backtest loop-----" << std::endl;
 
@@ -30,8 +95,14 @@ int main() {
     for (int i = 0; i < 4; i++) {
         std::cout << "Row: " << i + 1 << ", Updating bars" << std::endl;
 
-        // Handler ticks forward
-        dataHandler.updateBars();
+        // Handler ticks forward (the sharded engine also runs the
+        // strategies and queues their output behind the MarketEvent)
+        if (engine) {
+            engine->step();
+        }
+        else {
+            dataHandler.updateBars();
+        }
 
         // Check if Handler pushed event to queue
         // while loop ensures Market events processed in parallel
@@ -56,8 +127,13 @@ int main() {
                     std::cout << "Returns: " << bar.returns << std::endl;
                 }
 
-                // Test strategy on data
-                strategy.calculateSignals();
+                // Test strategy on data (already done by the shards)
+                if (engine) {
+                    engine->flushLog();
+                }
+                else {
+                    strategy->calculateSignals();
+                }
             }
 
             else if (event->getEventType() == EventType::SIGNAL) {
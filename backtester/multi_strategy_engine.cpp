@@ -0,0 +1,88 @@
+#include "multi_strategy_engine.h"
+
+MultiStrategyEngine::MultiStrategyEngine(DataHandler* data, std::queue<std::shared_ptr<Event>>& events)
+    : data(data), events(events) {}
+
+MultiStrategyEngine::Pipeline& MultiStrategyEngine::attach(const std::string& name, StrategyFactory makeStrategy,
+                                                           PortfolioFactory makePortfolio, BrokerFactory makeBroker) {
+    auto pipeline = std::make_unique<Pipeline>();
+    pipeline->name = name;
+    pipeline->strategy = makeStrategy(data, pipeline->events, data->getSymbolList());
+    pipeline->portfolio = makePortfolio(data, pipeline->events);
+    pipeline->broker = makeBroker(data, pipeline->events);
+
+    pipelines.push_back(std::move(pipeline));
+    return *pipelines.back();
+}
+
+MultiStrategyEngine::Pipeline& MultiStrategyEngine::attach(const std::string& name, StrategyFactory makeStrategy,
+                                                           double initialCapital) {
+    return attach(
+        name, makeStrategy,
+        [initialCapital](DataHandler* d, std::queue<std::shared_ptr<Event>>& q) {
+            return std::make_unique<NaivePortfolio>(d, q, "", initialCapital);
+        },
+        [](DataHandler* d, std::queue<std::shared_ptr<Event>>& q) {
+            return std::make_unique<IntrabarExecutionHandler>(d, q);
+        });
+}
+
+bool MultiStrategyEngine::step() {
+    // Read the next bar once for all pipelines
+    data->updateBars();
+
+    if (events.empty()) {
+        return false; // No more data left
+    }
+
+    while (!events.empty()) {
+        std::shared_ptr<Event> event = events.front();
+        events.pop();
+
+        // Events are immutable, so pipelines can share the same object
+        for (auto& pipeline : pipelines) {
+            pipeline->events.push(event);
+        }
+    }
+
+    for (auto& pipeline : pipelines) {
+        process(*pipeline);
+    }
+
+    return true;
+}
+
+void MultiStrategyEngine::run() {
+    while (step()) {}
+}
+
+const std::vector<std::unique_ptr<MultiStrategyEngine::Pipeline>>& MultiStrategyEngine::getPipelines() const {
+    return pipelines;
+}
+
+void MultiStrategyEngine::process(Pipeline& pipeline) {
+    while (!pipeline.events.empty()) {
+        std::shared_ptr<Event> event = pipeline.events.front();
+        pipeline.events.pop();
+
+        switch (event->getEventType()) {
+            case EventType::MARKET:
+                pipeline.portfolio->updateTimeIndex(event);
+                pipeline.broker->updateBars();
+                pipeline.strategy->calculateSignals();
+                break;
+            case EventType::SIGNAL:
+                pipeline.portfolio->updateSignal(std::static_pointer_cast<SignalEvent>(event));
+                break;
+            case EventType::ORDER:
+                pipeline.broker->executeOrder(std::static_pointer_cast<OrderEvent>(event));
+                break;
+            case EventType::FILL: {
+                auto fill = std::static_pointer_cast<FillEvent>(event);
+                pipeline.portfolio->updateFill(fill);
+                pipeline.strategy->updateFill(fill);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <queue>
+#include <memory>
+#include <functional>
+
+#include "event.h"
+#include "data_handler.h"
+#include "strategy.h"
+#include "portfolio.h"
+#include "execution.h"
+
+class MultiStrategyEngine {
+    /*
+    MultiStrategyEngine runs several Strategy/Portfolio pipelines off
+    a single pass over one DataHandler. The data is read, parsed and
+    aligned once; every updateBars step then fans the MarketEvent out
+    to all attached pipelines, which read the same bars back to back
+    while they are still in cache.
+
+    Each pipeline keeps its own event queue, NaivePortfolio and
+    simulated broker, so their accounting is fully independent and
+    identical to running each strategy on its own.
+    */
+
+public:
+    // Builds a pipeline's NaivePortfolio (or subclass) on its own queue
+    using PortfolioFactory = std::function<std::unique_ptr<NaivePortfolio>(
+        DataHandler*, std::queue<std::shared_ptr<Event>>&)>;
+
+    // Builds a pipeline's simulated broker on its own queue
+    using BrokerFactory = std::function<std::unique_ptr<IntrabarExecutionHandler>(
+        DataHandler*, std::queue<std::shared_ptr<Event>>&)>;
+
+    struct Pipeline {
+        std::string name;
+        std::queue<std::shared_ptr<Event>> events;
+        std::unique_ptr<Strategy> strategy;
+        std::unique_ptr<NaivePortfolio> portfolio;
+        std::unique_ptr<IntrabarExecutionHandler> broker;
+    };
+
+    /*
+    Parameters:
+    data - The DataHandler shared (read-only) by all pipelines.
+    events - The Event Queue the DataHandler pushes onto.
+    */
+    MultiStrategyEngine(DataHandler* data, std::queue<std::shared_ptr<Event>>& events);
+
+    /*
+    Attaches a new pipeline. Must be called before the first step.
+
+    Parameters:
+    name - Label for the pipeline, e.g. the strategy name.
+    makeStrategy - Creates the pipeline's Strategy.
+    makePortfolio - Creates its portfolio, e.g. with a ResultsWriter attached.
+    makeBroker - Creates its broker, e.g. with another IntrabarPath or seed.
+    */
+    Pipeline& attach(const std::string& name, StrategyFactory makeStrategy,
+                     PortfolioFactory makePortfolio, BrokerFactory makeBroker);
+
+    // Same with a default NaivePortfolio and an OHLC IntrabarExecutionHandler
+    Pipeline& attach(const std::string& name, StrategyFactory makeStrategy,
+                     double initialCapital = 100000.0);
+
+    /*
+    Advances the DataHandler by one bar and runs every pipeline on it
+    until its queue is empty. Returns false once there is no more data.
+    */
+    bool step();
+
+    // Steps until the data is exhausted
+    void run();
+
+    const std::vector<std::unique_ptr<Pipeline>>& getPipelines() const;
+
+private:
+    DataHandler* data;
+    std::queue<std::shared_ptr<Event>>& events;
+    std::vector<std::unique_ptr<Pipeline>> pipelines;
+
+    // Same dispatch as the single-strategy event loop
+    static void process(Pipeline& pipeline);
+};
@@ -52,3 +52,110 @@ void NaivePortfolio::constructCurrentHoldings() {
     currentHoldings["total"] = initialCapital;
 }
 
+void NaivePortfolio::updateTimeIndex(std::shared_ptr<Event> /*event*/) {
+    if (symbolList.empty()) {
+        return;
+    }
+
+    std::vector<Bar> latest = bars->getLatestBars(symbolList[0]);
+    if (latest.empty()) {
+        return;
+    }
+    time_t latestDatetime = latest[0].date;
+
+    // Update positions (quantities are unchanged by a new bar)
+    std::map<std::string, long> dp = currentPositions;
+
+    // Update holdings at the latest close
+    std::map<std::string, double> dh;
+    dh["cash"] = currentHoldings["cash"];
+    dh["commission"] = currentHoldings["commission"];
+    dh["total"] = currentHoldings["cash"];
+
+    for (const auto& s : symbolList) {
+        std::vector<Bar> symbolBars = bars->getLatestBars(s);
+        double close = symbolBars.empty() ? 0.0 : symbolBars[0].close;
+
+        // Approximation to the real value
+        double marketValue = currentPositions[s] * close;
+        dh[s] = marketValue;
+        dh["total"] += marketValue;
+    }
+
+    if (results) {
+        results->writePositions(latestDatetime, dp);
+        results->writeHoldings(latestDatetime, dh);
+    }
+    else {
+        allPositions.push_back(dp);
+        allHoldings.push_back(dh);
+    }
+}
+
+void NaivePortfolio::setResultsWriter(ResultsWriter* writer) {
+    results = writer;
+}
+
+const std::vector<std::map<std::string, long>>& NaivePortfolio::getAllPositions() const {
+    return allPositions;
+}
+
+const std::vector<std::map<std::string, double>>& NaivePortfolio::getAllHoldings() const {
+    return allHoldings;
+}
+
+void NaivePortfolio::updatePositionsFromFill(std::shared_ptr<FillEvent> fill) {
+    // Check whether the fill is a buy or sell
+    long fillDir = (fill->direction == DirectionType::BUY) ? 1 : -1;
+
+    currentPositions[fill->symbol] += fillDir * static_cast<long>(fill->quantity);
+}
+
+void NaivePortfolio::updateHoldingsFromFill(std::shared_ptr<FillEvent> fill) {
+    double fillDir = (fill->direction == DirectionType::BUY) ? 1.0 : -1.0;
+
+    // fillCost is the per-share price the order was filled at
+    double cost = fillDir * static_cast<double>(fill->fillCost) * fill->quantity;
+    double commission = static_cast<double>(fill->commission);
+
+    currentHoldings[fill->symbol] += cost;
+    currentHoldings["commission"] += commission;
+    currentHoldings["cash"] -= (cost + commission);
+    currentHoldings["total"] -= commission;
+}
+
+void NaivePortfolio::updateFill(std::shared_ptr<FillEvent> event) {
+    updatePositionsFromFill(event);
+    updateHoldingsFromFill(event);
+
+    if (results) {
+        results->writeFill(*event);
+    }
+}
+
+void NaivePortfolio::generateNaiveOrder(std::shared_ptr<SignalEvent> signal) {
+    long curQuantity = currentPositions[signal->symbol];
+
+    std::shared_ptr<OrderEvent> order;
+
+    if (signal->signalType == SignalType::LONG && curQuantity == 0) {
+        order = std::make_shared<OrderEvent>(signal->symbol, OrderType::MKT, mktQuantity, DirectionType::BUY);
+    }
+    else if (signal->signalType == SignalType::SHORT && curQuantity == 0) {
+        order = std::make_shared<OrderEvent>(signal->symbol, OrderType::MKT, mktQuantity, DirectionType::SELL);
+    }
+    else if (signal->signalType == SignalType::EXIT && curQuantity > 0) {
+        order = std::make_shared<OrderEvent>(signal->symbol, OrderType::MKT, curQuantity, DirectionType::SELL);
+    }
+    else if (signal->signalType == SignalType::EXIT && curQuantity < 0) {
+        order = std::make_shared<OrderEvent>(signal->symbol, OrderType::MKT, -curQuantity, DirectionType::BUY);
+    }
+
+    if (order) {
+        events.push(order);
+    }
+}
+
+void NaivePortfolio::updateSignal(std::shared_ptr<SignalEvent> event) {
+    generateNaiveOrder(event);
+}
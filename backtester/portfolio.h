@@ -8,6 +8,7 @@
 
 #include "event.h"
 #include "data_handler.h"
+#include "results_writer.h"
 
 class Portfolio {
     /*
@@ -64,8 +65,24 @@ public:
     */
     void updateTimeIndex(std::shared_ptr<Event> event);
 
-    // For equity history if needed later
-    // std::vector<std::map<std::string, double>>& getHistory();
+    /*
+    Streams every positions/holdings row and fill to the writer
+    instead of keeping the per-bar history in memory. The writer
+    must outlive the portfolio (or be detached with nullptr).
+    */
+    void setResultsWriter(ResultsWriter* writer);
+
+    /*
+    Per-bar history, starting with the initial row built in the
+    constructor. While a ResultsWriter is attached only that initial
+    row is kept; it is not written to the results file, which starts
+    at the first bar.
+    */
+    const std::vector<std::map<std::string, long>>& getAllPositions() const;
+    const std::vector<std::map<std::string, double>>& getAllHoldings() const;
+
+    // Constant order size used for every signal
+    static constexpr unsigned long mktQuantity = 100;
 
 private:
     DataHandler* bars;
@@ -80,6 +97,8 @@ private:
     std::map<std::string, double> currentHoldings;
     std::vector<std::map<std::string, double>> allHoldings;
 
+    ResultsWriter* results = nullptr; // Optional results sink
+
     /*
     Constructs the holdings list using the start_date
     to determine when the time index will begin.
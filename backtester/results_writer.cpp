@@ -0,0 +1,393 @@
+#include <iostream>
+#include <cstring>
+#include <bit>
+#include <utility>
+
+#include "results_writer.h"
+
+namespace {
+
+constexpr char resultsMagic[4] = {'B', 'T', 'R', 'S'};
+constexpr uint32_t resultsVersion = 1;
+
+// Column names and types of a table, shared by writer and reader
+std::vector<std::pair<std::string, ColumnType>> columnSchema(ResultsTable table,
+                                                             const std::vector<std::string>& symbolList) {
+    std::vector<std::pair<std::string, ColumnType>> schema = {{"datetime", ColumnType::INT64}};
+
+    switch (table) {
+        case ResultsTable::POSITIONS:
+            for (const auto& s : symbolList) {
+                schema.push_back({s, ColumnType::INT64});
+            }
+            break;
+        case ResultsTable::HOLDINGS:
+            for (const auto& s : symbolList) {
+                schema.push_back({s, ColumnType::FLOAT64});
+            }
+            schema.push_back({"cash", ColumnType::FLOAT64});
+            schema.push_back({"commission", ColumnType::FLOAT64});
+            schema.push_back({"total", ColumnType::FLOAT64});
+            break;
+        case ResultsTable::FILLS:
+            schema.push_back({"symbol", ColumnType::INT64});
+            schema.push_back({"direction", ColumnType::INT64});
+            schema.push_back({"quantity", ColumnType::INT64});
+            schema.push_back({"fillCost", ColumnType::FLOAT64});
+            schema.push_back({"commission", ColumnType::FLOAT64});
+            break;
+        case ResultsTable::EQUITY:
+            schema.push_back({"total", ColumnType::FLOAT64});
+            schema.push_back({"returns", ColumnType::FLOAT64});
+            break;
+    }
+
+    return schema;
+}
+
+template <typename T>
+void writeRaw(std::vector<char>& out, const T& value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+bool readRaw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}
+
+ResultsWriter::ResultsWriter(const std::string& path, std::vector<std::string> symbolList,
+                             uint32_t blockRows)
+    : file(path, std::ios::binary | std::ios::trunc), symbolList(symbolList),
+      blockRows(blockRows == 0 ? 1 : blockRows) {
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening results file" << std::endl;
+        failed = true;
+    }
+
+    for (size_t i = 0; i < symbolList.size(); i++) {
+        symbolIndex[symbolList[i]] = static_cast<int64_t>(i);
+    }
+
+    initBlock(positions, ResultsTable::POSITIONS, columnSchema(ResultsTable::POSITIONS, symbolList).size());
+    initBlock(holdings, ResultsTable::HOLDINGS, columnSchema(ResultsTable::HOLDINGS, symbolList).size());
+    initBlock(fills, ResultsTable::FILLS, columnSchema(ResultsTable::FILLS, symbolList).size());
+    initBlock(equity, ResultsTable::EQUITY, columnSchema(ResultsTable::EQUITY, symbolList).size());
+
+    writeHeader();
+    flusher = std::thread(&ResultsWriter::flusherLoop, this);
+}
+
+ResultsWriter::~ResultsWriter() {
+    close();
+}
+
+void ResultsWriter::writePositions(time_t datetime, const std::map<std::string, long>& positionsRow) {
+    put(positions, 0, static_cast<int64_t>(datetime));
+
+    for (size_t i = 0; i < symbolList.size(); i++) {
+        auto it = positionsRow.find(symbolList[i]);
+        put(positions, i + 1, static_cast<int64_t>(it == positionsRow.end() ? 0 : it->second));
+    }
+
+    commitRow(positions);
+}
+
+void ResultsWriter::writeHoldings(time_t datetime, const std::map<std::string, double>& holdingsRow) {
+    auto value = [&holdingsRow](const std::string& key) {
+        auto it = holdingsRow.find(key);
+        return it == holdingsRow.end() ? 0.0 : it->second;
+    };
+
+    put(holdings, 0, static_cast<int64_t>(datetime));
+
+    size_t col = 1;
+    for (const auto& s : symbolList) {
+        put(holdings, col++, value(s));
+    }
+
+    double total = value("total");
+    put(holdings, col++, value("cash"));
+    put(holdings, col++, value("commission"));
+    put(holdings, col++, total);
+    commitRow(holdings);
+
+    // Equity curve row
+    double returns = (hasLastTotal && lastTotal != 0.0) ? (total - lastTotal) / lastTotal : 0.0;
+    lastTotal = total;
+    hasLastTotal = true;
+
+    put(equity, 0, static_cast<int64_t>(datetime));
+    put(equity, 1, total);
+    put(equity, 2, returns);
+    commitRow(equity);
+}
+
+void ResultsWriter::writeFill(const FillEvent& fill) {
+    auto it = symbolIndex.find(fill.symbol);
+
+    put(fills, 0, static_cast<int64_t>(fill.timeIndex));
+    put(fills, 1, static_cast<int64_t>(it == symbolIndex.end() ? -1 : it->second));
+    put(fills, 2, static_cast<int64_t>(fill.direction == DirectionType::BUY ? 1 : -1));
+    put(fills, 3, static_cast<int64_t>(fill.quantity));
+    put(fills, 4, static_cast<double>(fill.fillCost));
+    put(fills, 5, static_cast<double>(fill.commission));
+    commitRow(fills);
+}
+
+bool ResultsWriter::close() {
+    if (closed) {
+        return good();
+    }
+    closed = true;
+
+    flushBlock(positions);
+    flushBlock(holdings);
+    flushBlock(fills);
+    flushBlock(equity);
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        stopFlusher = true;
+    }
+    pendingCV.notify_all();
+    flusher.join();
+
+    file.close();
+    if (file.fail() && !failed) {
+        std::cerr << "Error writing results file" << std::endl;
+        failed = true;
+    }
+
+    return !failed;
+}
+
+bool ResultsWriter::good() const {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return !failed;
+}
+
+void ResultsWriter::writeHeader() {
+    std::vector<char> header;
+    header.insert(header.end(), resultsMagic, resultsMagic + 4);
+    writeRaw(header, resultsVersion);
+    writeRaw(header, blockRows);
+    writeRaw(header, static_cast<uint32_t>(symbolList.size()));
+
+    for (const auto& s : symbolList) {
+        writeRaw(header, static_cast<uint32_t>(s.size()));
+        header.insert(header.end(), s.begin(), s.end());
+    }
+
+    if (!file.write(header.data(), header.size()) && !failed) {
+        std::cerr << "Error writing results file" << std::endl;
+        failed = true;
+    }
+}
+
+void ResultsWriter::initBlock(ColumnBlock& block, ResultsTable table, size_t numColumns) {
+    block.table = table;
+    block.columns.resize(numColumns);
+
+    for (auto& c : block.columns) {
+        c.reserve(blockRows);
+    }
+}
+
+void ResultsWriter::commitRow(ColumnBlock& block) {
+    block.rows++;
+
+    if (block.rows >= blockRows) {
+        flushBlock(block);
+    }
+}
+
+void ResultsWriter::flushBlock(ColumnBlock& block) {
+    if (block.rows == 0) {
+        return;
+    }
+
+    // Serialise: table id, row count, then each column back to back
+    std::vector<char> chunk;
+    chunk.reserve(1 + sizeof(uint32_t) + block.columns.size() * block.rows * sizeof(uint64_t));
+    writeRaw(chunk, static_cast<uint8_t>(block.table));
+    writeRaw(chunk, block.rows);
+
+    for (auto& c : block.columns) {
+        const char* p = reinterpret_cast<const char*>(c.data());
+        chunk.insert(chunk.end(), p, p + c.size() * sizeof(uint64_t));
+        c.clear(); // Keeps capacity for the next block
+    }
+    block.rows = 0;
+
+    // Apply back-pressure if the flusher falls too far behind
+    std::unique_lock<std::mutex> lock(pendingMutex);
+    pendingCV.wait(lock, [this] { return pending.size() < maxPendingChunks; });
+    pending.push_back(std::move(chunk));
+    lock.unlock();
+    pendingCV.notify_all();
+}
+
+void ResultsWriter::flusherLoop() {
+    while (true) {
+        std::vector<char> chunk;
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingCV.wait(lock, [this] { return stopFlusher || !pending.empty(); });
+
+            if (pending.empty()) {
+                return; // Stopping and nothing left to write
+            }
+
+            chunk = std::move(pending.front());
+            pending.pop_front();
+        }
+        pendingCV.notify_all();
+
+        if (!file.write(chunk.data(), chunk.size())) {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            if (!failed) {
+                std::cerr << "Error writing results file" << std::endl;
+            }
+            failed = true;
+        }
+    }
+}
+
+void ResultsWriter::put(ColumnBlock& block, size_t column, int64_t value) {
+    block.columns[column].push_back(std::bit_cast<uint64_t>(value));
+}
+
+void ResultsWriter::put(ColumnBlock& block, size_t column, double value) {
+    block.columns[column].push_back(std::bit_cast<uint64_t>(value));
+}
+
+ResultsReader::ResultsReader(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        std::cerr << "Error opening results file" << std::endl;
+        return;
+    }
+
+    // Lengths read from the file are checked against what is left of
+    // it, so a corrupt file cannot trigger huge allocations
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    auto remaining = [&file, fileSize]() {
+        return fileSize - static_cast<uint64_t>(file.tellg());
+    };
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t blockRows = 0;
+    uint32_t numSymbols = 0;
+
+    if (!file.read(magic, 4) || std::memcmp(magic, resultsMagic, 4) != 0 ||
+        !readRaw(file, version) || version != resultsVersion ||
+        !readRaw(file, blockRows) || !readRaw(file, numSymbols)) {
+        std::cerr << "Not a results file" << std::endl;
+        return;
+    }
+
+    if (numSymbols > remaining() / sizeof(uint32_t)) {
+        std::cerr << "Truncated results header" << std::endl;
+        return;
+    }
+
+    for (uint32_t i = 0; i < numSymbols; i++) {
+        uint32_t len = 0;
+        if (!readRaw(file, len) || len > remaining()) {
+            std::cerr << "Truncated results header" << std::endl;
+            return;
+        }
+
+        std::string s(len, '\0');
+        if (!file.read(s.data(), len)) {
+            std::cerr << "Truncated results header" << std::endl;
+            return;
+        }
+        symbolList.push_back(s);
+    }
+
+    buildSchema();
+
+    // Read chunks until EOF, appending each column in place
+    uint8_t tableId = 0;
+    while (readRaw(file, tableId)) {
+        uint32_t rows = 0;
+        auto it = tables.find(static_cast<ResultsTable>(tableId));
+
+        if (!readRaw(file, rows) || it == tables.end()) {
+            std::cerr << "Corrupt results chunk" << std::endl;
+            return;
+        }
+
+        if (rows > remaining() / sizeof(uint64_t) / it->second.size()) {
+            std::cerr << "Truncated results chunk" << std::endl;
+            return;
+        }
+
+        for (auto& column : it->second) {
+            char* dest;
+            if (column.type == ColumnType::INT64) {
+                column.ints.resize(column.ints.size() + rows);
+                dest = reinterpret_cast<char*>(column.ints.data() + column.ints.size() - rows);
+            }
+            else {
+                column.reals.resize(column.reals.size() + rows);
+                dest = reinterpret_cast<char*>(column.reals.data() + column.reals.size() - rows);
+            }
+
+            if (!file.read(dest, static_cast<std::streamsize>(rows) * sizeof(uint64_t))) {
+                std::cerr << "Truncated results chunk" << std::endl;
+                return;
+            }
+        }
+    }
+
+    valid = true;
+}
+
+bool ResultsReader::good() const {
+    return valid;
+}
+
+const std::vector<std::string>& ResultsReader::getSymbolList() const {
+    return symbolList;
+}
+
+const std::vector<ResultsColumn>& ResultsReader::getTable(ResultsTable table) const {
+    return tables.at(table);
+}
+
+const ResultsColumn* ResultsReader::getColumn(ResultsTable table, const std::string& name) const {
+    auto it = tables.find(table);
+    if (it == tables.end()) {
+        return nullptr;
+    }
+
+    for (const auto& column : it->second) {
+        if (column.name == name) {
+            return &column;
+        }
+    }
+
+    return nullptr;
+}
+
+void ResultsReader::buildSchema() {
+    for (ResultsTable table : {ResultsTable::POSITIONS, ResultsTable::HOLDINGS,
+                               ResultsTable::FILLS, ResultsTable::EQUITY}) {
+        std::vector<ResultsColumn>& columns = tables[table];
+
+        for (const auto& [name, type] : columnSchema(table, symbolList)) {
+            columns.push_back(ResultsColumn{name, type, {}, {}});
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <deque>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+
+#include "event.h"
+
+/*
+Results files use a compact chunked columnar layout:
+
+    header: "BTRS" | u32 version | u32 blockRows | u32 numSymbols
+            | numSymbols x (u32 length | chars)
+    chunks: u8 table | u32 rowCount | column 0 ... column N-1
+
+Every column value is 8 bytes (int64 or double, host byte order) and
+each column of a chunk is stored contiguously, so the reader can copy
+it straight into its column vector. The column schema of every table
+is implied by the table id and the symbol list in the header.
+*/
+
+enum class ResultsTable : uint8_t {
+    POSITIONS, // datetime, <symbol quantities...>
+    HOLDINGS,  // datetime, <symbol market values...>, cash, commission, total
+    FILLS,     // datetime, symbol (index), direction (+1/-1), quantity, fillCost, commission
+    EQUITY     // datetime, total, returns
+};
+
+enum class ColumnType : uint8_t {
+    INT64,
+    FLOAT64
+};
+
+struct ResultsColumn {
+    std::string name;
+    ColumnType type;
+    std::vector<int64_t> ints;  // Used when type is INT64
+    std::vector<double> reals;  // Used when type is FLOAT64
+};
+
+class ResultsWriter {
+    /*
+    ResultsWriter streams the positions, holdings, fills and equity
+    curve of a backtest to disk while it runs.
+
+    Rows are buffered per table in fixed-size column blocks. A full
+    block is serialised into a chunk and handed to a background thread
+    which writes it out, so the simulation never blocks on disk unless
+    the writer falls several blocks behind. Memory use is therefore
+    bounded by the block size, whatever the length of the run.
+    */
+
+public:
+    /*
+    Parameters:
+    path - The output file, truncated if it exists.
+    symbolList - The symbols whose columns are written.
+    blockRows - Rows per chunk for every table.
+    */
+    ResultsWriter(const std::string& path, std::vector<std::string> symbolList,
+                  uint32_t blockRows = 4096);
+    ~ResultsWriter();
+
+    ResultsWriter(const ResultsWriter&) = delete;
+    ResultsWriter& operator=(const ResultsWriter&) = delete;
+
+    void writePositions(time_t datetime, const std::map<std::string, long>& positions);
+
+    // Also appends a row to the equity curve from the "total" holding
+    void writeHoldings(time_t datetime, const std::map<std::string, double>& holdings);
+
+    void writeFill(const FillEvent& fill);
+
+    /*
+    Flushes partial blocks and waits for the background writer.
+    Returns false if the file could not be opened or any write failed.
+    */
+    bool close();
+
+    // False once opening or writing the file has failed
+    bool good() const;
+
+private:
+    struct ColumnBlock {
+        ResultsTable table;
+        std::vector<std::vector<uint64_t>> columns; // Raw 8-byte values
+        uint32_t rows = 0;
+    };
+
+    std::ofstream file;
+    std::vector<std::string> symbolList;
+    std::map<std::string, int64_t> symbolIndex;
+    uint32_t blockRows;
+    bool closed = false;
+
+    ColumnBlock positions;
+    ColumnBlock holdings;
+    ColumnBlock fills;
+    ColumnBlock equity;
+    double lastTotal = 0.0;
+    bool hasLastTotal = false;
+
+    // Background flushing of serialised chunks
+    std::deque<std::vector<char>> pending;
+    mutable std::mutex pendingMutex;
+    std::condition_variable pendingCV;
+    bool stopFlusher = false;
+    bool failed = false; // Set by the flusher on a write error
+    std::thread flusher;
+
+    static constexpr size_t maxPendingChunks = 4;
+
+    void writeHeader();
+    void initBlock(ColumnBlock& block, ResultsTable table, size_t numColumns);
+
+    // Ends the current row and ships the block once it is full
+    void commitRow(ColumnBlock& block);
+    void flushBlock(ColumnBlock& block);
+    void flusherLoop();
+
+    static void put(ColumnBlock& block, size_t column, int64_t value);
+    static void put(ColumnBlock& block, size_t column, double value);
+};
+
+class ResultsReader {
+    /*
+    ResultsReader loads a file produced by ResultsWriter back into
+    memory, one vector per column, by reading each chunk's column
+    data directly into place.
+    */
+
+public:
+    explicit ResultsReader(const std::string& path);
+
+    // False if the file could not be opened or is not a results file
+    bool good() const;
+
+    const std::vector<std::string>& getSymbolList() const;
+
+    const std::vector<ResultsColumn>& getTable(ResultsTable table) const;
+
+    // Returns nullptr if the table has no column of that name
+    const ResultsColumn* getColumn(ResultsTable table, const std::string& name) const;
+
+private:
+    bool valid = false;
+    std::vector<std::string> symbolList;
+    std::map<ResultsTable, std::vector<ResultsColumn>> tables;
+
+    void buildSchema();
+};
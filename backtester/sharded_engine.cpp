@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <limits>
+#include <iostream>
+
+#include "sharded_engine.h"
+
+namespace {
+
+// Number of worker threads actually started for the symbol list
+unsigned shardCount(size_t numSymbols, unsigned requested) {
+    size_t n = std::min<size_t>(std::max(1u, requested), std::max<size_t>(1, numSymbols));
+    return static_cast<unsigned>(n);
+}
+
+}
+
+ShardedEventEngine::ShardedEventEngine(DataHandler* data,
+                                       std::queue<std::shared_ptr<Event>>& events,
+                                       StrategyFactory makeStrategy,
+                                       unsigned numShards)
+    : data(data), events(events),
+      startBarrier(shardCount(data->getSymbolList().size(), numShards) + 1),
+      doneBarrier(shardCount(data->getSymbolList().size(), numShards) + 1) {
+
+    std::vector<std::string> symbolList = data->getSymbolList();
+    unsigned n = shardCount(symbolList.size(), numShards);
+
+    for (unsigned i = 0; i < n; i++) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+
+    // Round-robin keeps each shard's symbols in symbol list order
+    for (size_t i = 0; i < symbolList.size(); i++) {
+        symbolRank[symbolList[i]] = i;
+        shards[i % n]->symbols.push_back(symbolList[i]);
+    }
+
+    for (auto& shard : shards) {
+        shard->strategy = makeStrategy(data, shard->events, shard->symbols);
+        shard->strategy->setLog(shard->log);
+    }
+
+    for (auto& shard : shards) {
+        workers.emplace_back(&ShardedEventEngine::workerLoop, this, std::ref(*shard));
+    }
+}
+
+ShardedEventEngine::~ShardedEventEngine() {
+    // Release the workers from the start barrier so they can exit
+    stopping = true;
+    startBarrier.arrive_and_wait();
+
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+bool ShardedEventEngine::step() {
+    // Handler ticks forward on the shared queue
+    data->updateBars();
+
+    if (events.empty()) {
+        return false; // No more data left
+    }
+
+    // Fan out this timestamp's market update to every shard, keeping
+    // it for the main loop too
+    std::vector<std::shared_ptr<Event>> market;
+    while (!events.empty()) {
+        std::shared_ptr<Event> event = events.front();
+        events.pop();
+        market.push_back(event);
+
+        for (auto& shard : shards) {
+            shard->events.push(event);
+        }
+    }
+
+    // Workers only read from the DataHandler between these two barriers
+    startBarrier.arrive_and_wait();
+    doneBarrier.arrive_and_wait();
+
+    // Concatenate in shard order then stable sort by symbol, so events
+    // for one symbol keep the order its Strategy emitted them in
+    std::vector<std::shared_ptr<Event>> merged;
+    for (auto& shard : shards) {
+        merged.insert(merged.end(), shard->outbox.begin(), shard->outbox.end());
+        shard->outbox.clear();
+
+        pendingLog << shard->log.str();
+        shard->log.str("");
+    }
+
+    std::stable_sort(merged.begin(), merged.end(),
+                     [this](const std::shared_ptr<Event>& a, const std::shared_ptr<Event>& b) {
+                         return rankOf(*a) < rankOf(*b);
+                     });
+
+    // The MarketEvent goes first, followed by what the strategies
+    // produced on it, exactly as the serial loop queues them
+    for (auto& event : market) {
+        events.push(event);
+    }
+    for (auto& event : merged) {
+        events.push(event);
+    }
+
+    return true;
+}
+
+void ShardedEventEngine::flushLog() {
+    std::cout << pendingLog.str();
+    pendingLog.str("");
+}
+
+unsigned ShardedEventEngine::getNumShards() const {
+    return static_cast<unsigned>(shards.size());
+}
+
+void ShardedEventEngine::workerLoop(Shard& shard) {
+    while (true) {
+        startBarrier.arrive_and_wait();
+
+        if (stopping) {
+            return;
+        }
+
+        processShard(shard);
+        doneBarrier.arrive_and_wait();
+    }
+}
+
+void ShardedEventEngine::processShard(Shard& shard) {
+    while (!shard.events.empty()) {
+        std::shared_ptr<Event> event = shard.events.front();
+        shard.events.pop();
+
+        if (event->getEventType() == EventType::MARKET) {
+            shard.strategy->calculateSignals();
+        }
+        else {
+            // Signals, orders and fills go back to the shared queue
+            shard.outbox.push_back(event);
+        }
+    }
+}
+
+size_t ShardedEventEngine::rankOf(const Event& event) const {
+    const std::string* symbol = nullptr;
+
+    switch (event.getEventType()) {
+        case EventType::SIGNAL:
+            symbol = &static_cast<const SignalEvent&>(event).symbol;
+            break;
+        case EventType::ORDER:
+            symbol = &static_cast<const OrderEvent&>(event).symbol;
+            break;
+        case EventType::FILL:
+            symbol = &static_cast<const FillEvent&>(event).symbol;
+            break;
+        default:
+            break;
+    }
+
+    if (symbol) {
+        auto it = symbolRank.find(*symbol);
+        if (it != symbolRank.end()) {
+            return it->second;
+        }
+    }
+
+    // Events without a known symbol go after all symbol events
+    return std::numeric_limits<size_t>::max();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <queue>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <barrier>
+#include <atomic>
+#include <sstream>
+
+#include "event.h"
+#include "data_handler.h"
+#include "strategy.h"
+
+class ShardedEventEngine {
+    /*
+    ShardedEventEngine runs per-symbol independent strategies in
+    parallel. The symbol list is split round-robin into shards, each
+    owning its own Strategy instance and its own event queue, and
+    every shard is handled by a dedicated worker thread.
+
+    Workers synchronise on a barrier at every timestamp. Once all
+    shards are done, the MarketEvent is put back on the shared event
+    queue, followed by the events the shards produced in symbol list
+    order. That is exactly the queue a single-threaded run builds
+    when its Strategy handles the MarketEvent, so everything
+    downstream (Portfolio, broker) sees the same event sequence, bit
+    for bit, as long as it does not call the strategies again on the
+    MarketEvent.
+
+    Strategy progress messages are buffered per shard, collected in
+    shard order and written by flushLog(), which the main loop calls
+    where it would have run the Strategy. Console output is thus
+    deterministic too (though grouped by shard rather than by symbol).
+    */
+
+public:
+    /*
+    Parameters:
+    data - The DataHandler shared (read-only) by all shards.
+    events - The shared Event Queue the DataHandler pushes onto.
+    makeStrategy - Creates the Strategy for each shard from its own queue and symbols.
+    numShards - Number of worker threads, capped at the symbol count.
+    */
+    ShardedEventEngine(DataHandler* data,
+                       std::queue<std::shared_ptr<Event>>& events,
+                       StrategyFactory makeStrategy,
+                       unsigned numShards);
+    ~ShardedEventEngine();
+
+    ShardedEventEngine(const ShardedEventEngine&) = delete;
+    ShardedEventEngine& operator=(const ShardedEventEngine&) = delete;
+
+    /*
+    Advances the DataHandler by one timestamp, runs every shard's
+    Strategy on the resulting MarketEvent and leaves the MarketEvent
+    and the produced events on the shared queue in deterministic order.
+    Returns false once there is no more data.
+    */
+    bool step();
+
+    // Writes the strategies' messages from the last step to std::cout
+    void flushLog();
+
+    unsigned getNumShards() const;
+
+private:
+    struct Shard {
+        std::vector<std::string> symbols;
+        std::queue<std::shared_ptr<Event>> events;
+        std::unique_ptr<Strategy> strategy;
+        std::vector<std::shared_ptr<Event>> outbox; // Non-market events left after draining
+        std::ostringstream log; // The strategy's messages for this timestamp
+    };
+
+    DataHandler* data;
+    std::queue<std::shared_ptr<Event>>& events;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::map<std::string, size_t> symbolRank; // Position in the original symbol list
+
+    std::vector<std::thread> workers;
+    std::barrier<> startBarrier;
+    std::barrier<> doneBarrier;
+    std::atomic<bool> stopping = false;
+    std::ostringstream pendingLog; // Shard messages since the last flushLog
+
+    void workerLoop(Shard& shard);
+
+    // Drains a shard's queue, running its Strategy on every MarketEvent
+    static void processShard(Shard& shard);
+
+    // Rank of the symbol carried by an event, used for the merge order
+    size_t rankOf(const Event& event) const;
+};
@@ -0,0 +1,279 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "shared_dataset.h"
+
+namespace {
+
+constexpr char datasetMagic[8] = {'B', 'T', 'S', 'H', 'M', 'D', 'S', '\0'};
+constexpr uint32_t datasetVersion = 1;
+
+int openRegion(const std::string& name, SharedBacking backing, int flags, mode_t mode) {
+    if (backing == SharedBacking::POSIX_SHM) {
+        return shm_open(name.c_str(), flags, mode);
+    }
+    return open(name.c_str(), flags, mode);
+}
+
+PackedBar pack(const Bar& bar) {
+    return PackedBar{static_cast<int64_t>(bar.date), bar.open, bar.high, bar.low, bar.close,
+                     static_cast<int64_t>(bar.vol), bar.adjClose, bar.returns};
+}
+
+Bar unpack(const PackedBar& packed, const std::string& symbol) {
+    Bar bar;
+    bar.symbol   = symbol;
+    bar.date     = static_cast<time_t>(packed.date);
+    bar.open     = packed.open;
+    bar.high     = packed.high;
+    bar.low      = packed.low;
+    bar.close    = packed.close;
+    bar.vol      = static_cast<long>(packed.vol);
+    bar.adjClose = packed.adjClose;
+    bar.returns  = packed.returns;
+    return bar;
+}
+
+}
+
+SharedDatasetPublisher::SharedDatasetPublisher(const std::string& name, const HistoricCSVDataHandler& source,
+                                               SharedBacking backing) {
+    const auto& symbolData = source.getSymbolData();
+
+    uint64_t totalBars = 0;
+    for (const auto& [symbol, bars] : symbolData) {
+        if (symbol.size() >= sizeof(SharedSymbolEntry::symbol)) {
+            std::cerr << "Symbol name too long for shared dataset: " << symbol << std::endl;
+            return;
+        }
+        totalBars += bars.size();
+    }
+
+    uint64_t barsOffset = sizeof(SharedDatasetHeader) + symbolData.size() * sizeof(SharedSymbolEntry);
+    barsOffset = (barsOffset + alignof(PackedBar) - 1) / alignof(PackedBar) * alignof(PackedBar);
+    uint64_t size = barsOffset + totalBars * sizeof(PackedBar);
+
+    // Unlink and create afresh rather than truncating, so processes that
+    // still map an earlier region under this name keep their own copy
+    remove(name, backing);
+    int fd = openRegion(name, backing, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Error creating shared dataset " << name << std::endl;
+        return;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Error sizing shared dataset " << name << std::endl;
+        close(fd);
+        remove(name, backing); // Do not leave an empty region behind
+        return;
+    }
+
+    void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the region alive
+
+    if (region == MAP_FAILED) {
+        std::cerr << "Error mapping shared dataset " << name << std::endl;
+        remove(name, backing); // Never marked ready, so unusable
+        return;
+    }
+
+    char* base = static_cast<char*>(region);
+    auto* header = reinterpret_cast<SharedDatasetHeader*>(base);
+    auto* entries = reinterpret_cast<SharedSymbolEntry*>(base + sizeof(SharedDatasetHeader));
+    auto* packed = reinterpret_cast<PackedBar*>(base + barsOffset);
+
+    std::memcpy(header->magic, datasetMagic, sizeof(datasetMagic));
+    header->version = datasetVersion;
+    header->numSymbols = static_cast<uint32_t>(symbolData.size());
+    header->totalBars = totalBars;
+    header->barsOffset = barsOffset;
+    header->size = size;
+
+    uint64_t next = 0;
+    size_t i = 0;
+    for (const auto& [symbol, bars] : symbolData) {
+        std::memset(entries[i].symbol, 0, sizeof(entries[i].symbol));
+        std::memcpy(entries[i].symbol, symbol.data(), symbol.size());
+        entries[i].firstBar = next;
+        entries[i].numBars = bars.size();
+
+        for (const auto& bar : bars) {
+            packed[next++] = pack(bar);
+        }
+        i++;
+    }
+
+    // Readers only trust the region once the flag is visible
+    std::atomic_ref<uint32_t>(header->ready).store(1, std::memory_order_release);
+
+    if (backing == SharedBacking::FILE_MMAP) {
+        msync(region, size, MS_SYNC);
+    }
+    munmap(region, size);
+
+    ok = true;
+}
+
+bool SharedDatasetPublisher::published() const {
+    return ok;
+}
+
+void SharedDatasetPublisher::remove(const std::string& name, SharedBacking backing) {
+    if (backing == SharedBacking::POSIX_SHM) {
+        shm_unlink(name.c_str());
+    }
+    else {
+        unlink(name.c_str());
+    }
+}
+
+SharedMemoryDataHandler::SharedMemoryDataHandler(std::queue<std::shared_ptr<Event>>& events,
+                                                 const std::string& name,
+                                                 std::vector<std::string> symbolList,
+                                                 SharedBacking backing)
+    : events(events), symbolList(symbolList) {
+    attach(name, backing);
+}
+
+SharedMemoryDataHandler::~SharedMemoryDataHandler() {
+    if (region) {
+        munmap(region, regionSize);
+    }
+}
+
+std::vector<Bar> SharedMemoryDataHandler::getLatestBars(std::string symbol, int N) {
+    // Check if symbol exists
+    auto it = views.find(symbol);
+    if (it == views.end()) {
+        std::cerr << "Symbol not available" << std::endl;
+        return {};
+    }
+
+    const SymbolView& view = it->second;
+    size_t count = std::min(view.latest, static_cast<size_t>(std::max(N, 0)));
+
+    std::vector<Bar> bars;
+    bars.reserve(count);
+    for (size_t i = view.latest - count; i < view.latest; i++) {
+        bars.push_back(unpack(view.bars[i], symbol));
+    }
+
+    return bars;
+}
+
+void SharedMemoryDataHandler::updateBars() {
+    bool newBarAdd = false;
+
+    for (const auto& s : symbolList) {
+        auto it = views.find(s);
+
+        // Check if end of data reached for symbol s
+        if (it == views.end() || it->second.latest >= it->second.numBars) {
+            continue;
+        }
+
+        it->second.latest++;
+        newBarAdd = true;
+    }
+
+    // If at least one symbol had a new bar, push a MarketEvent
+    if (newBarAdd) {
+        events.push(std::make_shared<MarketEvent>());
+    }
+    else {
+        contBacktest = false; // No more data left
+    }
+}
+
+std::vector<std::string> SharedMemoryDataHandler::getSymbolList() {
+    return symbolList;
+}
+
+bool SharedMemoryDataHandler::attached() const {
+    return region != nullptr;
+}
+
+void SharedMemoryDataHandler::attach(const std::string& name, SharedBacking backing) {
+    int fd = openRegion(name, backing, O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Error opening shared dataset " << name << std::endl;
+        return;
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedDatasetHeader)) {
+        std::cerr << "Shared dataset " << name << " is empty" << std::endl;
+        close(fd);
+        return;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Error mapping shared dataset " << name << std::endl;
+        return;
+    }
+
+    const char* base = static_cast<const char*>(mapped);
+    const auto* header = reinterpret_cast<const SharedDatasetHeader*>(base);
+    uint32_t ready = std::atomic_ref<uint32_t>(const_cast<uint32_t&>(header->ready)).load(std::memory_order_acquire);
+
+    if (std::memcmp(header->magic, datasetMagic, sizeof(datasetMagic)) != 0 ||
+        header->version != datasetVersion || !ready || header->size != size) {
+        std::cerr << "Shared dataset " << name << " is not ready or invalid" << std::endl;
+        munmap(mapped, size);
+        return;
+    }
+
+    // Every offset read from the region must stay inside it
+    uint64_t entriesEnd = sizeof(SharedDatasetHeader) + uint64_t(header->numSymbols) * sizeof(SharedSymbolEntry);
+    uint64_t barsOffset = header->barsOffset;
+    uint64_t totalBars = header->totalBars;
+
+    bool valid = entriesEnd <= size && barsOffset >= entriesEnd && barsOffset <= size &&
+                 barsOffset % alignof(PackedBar) == 0 &&
+                 totalBars <= (size - barsOffset) / sizeof(PackedBar);
+
+    const auto* entries = reinterpret_cast<const SharedSymbolEntry*>(base + sizeof(SharedDatasetHeader));
+
+    for (uint32_t i = 0; valid && i < header->numSymbols; i++) {
+        valid = std::memchr(entries[i].symbol, '\0', sizeof(entries[i].symbol)) != nullptr &&
+                entries[i].firstBar <= totalBars && entries[i].numBars <= totalBars - entries[i].firstBar;
+    }
+
+    if (!valid) {
+        std::cerr << "Shared dataset " << name << " is corrupt" << std::endl;
+        munmap(mapped, size);
+        return;
+    }
+
+    region = mapped;
+    regionSize = size;
+
+    const auto* packed = reinterpret_cast<const PackedBar*>(base + barsOffset);
+
+    std::map<std::string, const SharedSymbolEntry*> published;
+    for (uint32_t i = 0; i < header->numSymbols; i++) {
+        published[entries[i].symbol] = &entries[i];
+    }
+
+    for (const auto& s : symbolList) {
+        auto it = published.find(s);
+        if (it == published.end()) {
+            std::cerr << "Symbol " << s << " not in shared dataset" << std::endl;
+            continue;
+        }
+
+        views[s] = SymbolView{packed + it->second->firstBar, it->second->numBars, 0};
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <queue>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+#include "event.h"
+#include "data_handler.h"
+
+/*
+Shared dataset layout (all offsets from the start of the region):
+
+    SharedDatasetHeader
+    SharedSymbolEntry x numSymbols
+    PackedBar x totalBars   (at barsOffset, symbols back to back)
+
+The region is written once by a publisher and then only ever mapped
+read-only, so readers need no locking beyond checking the ready flag.
+*/
+
+enum class SharedBacking {
+    POSIX_SHM, // Named segment from shm_open, e.g. "/backtest_daily"
+    FILE_MMAP  // Regular file mapped with mmap, e.g. "/dev/shm/daily.bin"
+};
+
+struct SharedDatasetHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t ready;       // Set last, with release semantics
+    uint32_t numSymbols;
+    uint32_t reserved;
+    uint64_t totalBars;
+    uint64_t barsOffset;
+    uint64_t size;        // Total bytes of the region
+};
+
+struct SharedSymbolEntry {
+    char symbol[32];
+    uint64_t firstBar;    // Index into the PackedBar array
+    uint64_t numBars;
+};
+
+// Bar without the std::string, so it can live in shared memory
+struct PackedBar {
+    int64_t date;
+    double open;
+    double high;
+    double low;
+    double close;
+    int64_t vol;
+    double adjClose;
+    double returns;
+};
+
+class SharedDatasetPublisher {
+    /*
+    Copies the aligned and padded data of a HistoricCSVDataHandler
+    into a named shared memory segment (or mmap'd file) so other
+    backtest processes can attach to it instead of re-reading and
+    re-aligning the CSV files themselves.
+
+    The segment outlives the publisher; call remove() once no more
+    processes need it. Republishing under the same name unlinks the
+    old region first, so readers that still map it are unaffected.
+    */
+
+public:
+    /*
+    Parameters:
+    name - Segment name (POSIX_SHM) or file path (FILE_MMAP).
+    source - The loaded DataHandler whose data is published.
+    backing - Where the region lives.
+    */
+    SharedDatasetPublisher(const std::string& name, const HistoricCSVDataHandler& source,
+                           SharedBacking backing = SharedBacking::POSIX_SHM);
+
+    // True if the region was created and fully written
+    bool published() const;
+
+    // Unlinks the segment (or deletes the file)
+    static void remove(const std::string& name, SharedBacking backing = SharedBacking::POSIX_SHM);
+
+private:
+    bool ok = false;
+};
+
+class SharedMemoryDataHandler : public DataHandler {
+    /*
+    SharedMemoryDataHandler serves bars from a dataset published by
+    SharedDatasetPublisher, behaving exactly like the
+    HistoricCSVDataHandler it was published from. The region is
+    mapped read-only and never copied, so each process only keeps a
+    bar index per symbol.
+    */
+
+public:
+    /*
+    Parameters:
+    events - The Event Queue.
+    name - Segment name (POSIX_SHM) or file path (FILE_MMAP).
+    symbolList - A list of symbol strings, all of which must be published.
+    backing - Where the region lives.
+    */
+    SharedMemoryDataHandler(std::queue<std::shared_ptr<Event>>& events, const std::string& name,
+                            std::vector<std::string> symbolList,
+                            SharedBacking backing = SharedBacking::POSIX_SHM);
+    ~SharedMemoryDataHandler() override;
+
+    SharedMemoryDataHandler(const SharedMemoryDataHandler&) = delete;
+    SharedMemoryDataHandler& operator=(const SharedMemoryDataHandler&) = delete;
+
+    std::vector<Bar> getLatestBars(std::string symbol, int N = 1) override;
+
+    void updateBars() override;
+
+    std::vector<std::string> getSymbolList() override;
+
+    // False if the region could not be attached
+    bool attached() const;
+
+private:
+    struct SymbolView {
+        const PackedBar* bars = nullptr;
+        size_t numBars = 0;
+        size_t latest = 0; // Number of bars pushed to the simulation so far
+    };
+
+    std::queue<std::shared_ptr<Event>>& events;
+    std::vector<std::string> symbolList;
+    std::map<std::string, SymbolView> views;
+    void* region = nullptr;
+    size_t regionSize = 0;
+    bool contBacktest = true;
+
+    void attach(const std::string& name, SharedBacking backing);
+};
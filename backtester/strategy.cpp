@@ -36,7 +36,7 @@ void BuyAndHoldStrategy::calculateSignals() {
                 events.push(signal);
                 boughtStatus[s] = true;
                 
-                std::cout << "LONG " << s << " at " << latestBar.close << std::endl;
+                *log << "LONG " << s << " at " << latestBar.close << std::endl;
             }
         }
     }
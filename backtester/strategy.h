@@ -5,6 +5,8 @@
 #include <string>
 #include <queue>
 #include <memory>
+#include <functional>
+#include <iostream>
 
 #include "event.h"
 #include "data_handler.h"
@@ -27,8 +29,21 @@ public:
 
     // Provides mechanisms to calculate the list of signals.
     virtual void calculateSignals() = 0;
+
+    // Called with every FillEvent after the Portfolio has processed it
+    virtual void updateFill(std::shared_ptr<FillEvent> /*fill*/) {}
+
+    // Redirects progress messages (std::cout by default)
+    void setLog(std::ostream& out) { log = &out; }
+
+protected:
+    std::ostream* log = &std::cout;
 };
 
+// Builds a Strategy for the given symbols on its own event queue
+using StrategyFactory = std::function<std::unique_ptr<Strategy>(
+    DataHandler*, std::queue<std::shared_ptr<Event>>&, std::vector<std::string>)>;
+
 class BuyAndHoldStrategy : public Strategy {
     /*
     This is an extremely simple strategy that goes LONG all of the 
@@ -0,0 +1,313 @@
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "vectorized_backtest.h"
+#include "portfolio.h"
+#include "multi_strategy_engine.h"
+
+namespace {
+
+// Only the sign of a target is used: +1 long, -1 short, 0 flat
+int targetSign(int target) {
+    return (target > 0) - (target < 0);
+}
+
+BarColumns toColumns(const std::vector<Bar>& bars) {
+    BarColumns cols;
+    size_t n = bars.size();
+
+    cols.date.resize(n);
+    cols.open.resize(n);
+    cols.high.resize(n);
+    cols.low.resize(n);
+    cols.close.resize(n);
+    cols.adjClose.resize(n);
+    cols.vol.resize(n);
+
+    for (size_t i = 0; i < n; i++) {
+        cols.date[i]     = bars[i].date;
+        cols.open[i]     = bars[i].open;
+        cols.high[i]     = bars[i].high;
+        cols.low[i]      = bars[i].low;
+        cols.close[i]    = bars[i].close;
+        cols.adjClose[i] = bars[i].adjClose;
+        cols.vol[i]      = bars[i].vol;
+    }
+
+    return cols;
+}
+
+}
+
+SignalFunction movingAverageCross(size_t shortWindow, size_t longWindow) {
+    return [shortWindow, longWindow](const BarColumns& bars, std::vector<int>& target) {
+        const std::vector<double>& close = bars.close;
+        size_t n = close.size();
+        target.assign(n, 0);
+
+        if (shortWindow == 0 || longWindow == 0) {
+            return;
+        }
+
+        // Rolling sums, so target[t] only depends on closes up to t
+        double shortSum = 0.0;
+        double longSum = 0.0;
+
+        for (size_t t = 0; t < n; t++) {
+            shortSum += close[t];
+            longSum += close[t];
+
+            if (t >= shortWindow) {
+                shortSum -= close[t - shortWindow];
+            }
+            if (t >= longWindow) {
+                longSum -= close[t - longWindow];
+            }
+
+            if (t + 1 >= longWindow && t + 1 >= shortWindow) {
+                target[t] = (shortSum / shortWindow > longSum / longWindow) ? 1 : 0;
+            }
+        }
+    };
+}
+
+VectorizedBacktest::VectorizedBacktest(const HistoricCSVDataHandler& data, std::vector<std::string> symbolList,
+                                       SignalFunction signal, double initialCapital)
+    : data(data), symbolList(symbolList), signal(signal), initialCapital(initialCapital) {}
+
+VectorizedResult VectorizedBacktest::run() const {
+    VectorizedResult result;
+    const auto& symbolData = data.getSymbolData();
+
+    // HistoricCSVDataHandler replays every series from its own first
+    // bar, one bar per step, and a series that runs out keeps serving
+    // its last bar. Columns are aligned the same way, by step index.
+    size_t T = 0;
+    for (const auto& s : symbolList) {
+        auto it = symbolData.find(s);
+        if (it != symbolData.end()) {
+            T = std::max(T, it->second.size());
+        }
+    }
+
+    // Per-symbol columns indexed by k, turned into maps once at the end
+    const size_t numSymbols = symbolList.size();
+    std::vector<std::vector<double>> marketValue(numSymbols, std::vector<double>(T, 0.0));
+    std::vector<std::vector<double>> cashFlow(numSymbols, std::vector<double>(T, 0.0));
+    std::vector<std::vector<double>> commission(numSymbols, std::vector<double>(T, 0.0));
+    std::vector<std::vector<long>> positionBefore(numSymbols, std::vector<long>(T, 0));
+    std::vector<time_t> dates;
+
+    const long q = static_cast<long>(NaivePortfolio::mktQuantity);
+
+    for (size_t k = 0; k < numSymbols; k++) {
+        auto it = symbolData.find(symbolList[k]);
+        if (it == symbolData.end()) {
+            std::cerr << "Symbol not available" << std::endl;
+            continue;
+        }
+
+        BarColumns cols = toColumns(it->second);
+        size_t n = cols.close.size();
+        if (n == 0) {
+            continue;
+        }
+
+        std::vector<int> target;
+        signal(cols, target);
+        target.resize(n, 0);
+
+        // Hold the last bar (and so the last target) until the end
+        cols.date.resize(T, cols.date.back());
+        cols.close.resize(T, cols.close.back());
+        target.resize(T, target.back());
+        n = T;
+
+        if (k == 0) {
+            dates = cols.date; // NaivePortfolio dates its rows by the first symbol
+        }
+
+        // Position state machine of NaivePortfolio::generateNaiveOrder:
+        // enter only when flat, EXIT closes whatever is held. Only the
+        // sign of the target matters, as for SignalFunctionStrategy.
+        std::vector<long>& before = positionBefore[k];
+        std::vector<double> pos(n, 0.0);
+        std::vector<double> prev(n, 0.0);
+        long cur = 0;
+        for (size_t t = 0; t < n; t++) {
+            // Rows record the position before this bar's fill
+            before[t] = cur;
+            prev[t] = static_cast<double>(cur);
+
+            int tgt = targetSign(target[t]);
+            if (tgt == 0) {
+                cur = 0;
+            }
+            else if (cur == 0) {
+                cur = tgt * q;
+            }
+            pos[t] = static_cast<double>(cur);
+        }
+
+        // Branch-free whole-column passes over doubles from here on
+        const double* close = cols.close.data();
+        const double* posD = pos.data();
+        const double* prevD = prev.data();
+        double* mv = marketValue[k].data();
+        double* flow = cashFlow[k].data();
+        double* comm = commission[k].data();
+
+        for (size_t t = 0; t < n; t++) {
+            mv[t] = prevD[t] * close[t]; // Marked at this bar's close, before its fills
+        }
+
+        for (size_t t = 0; t < n; t++) {
+            double trade = posD[t] - prevD[t];
+            double traded = trade != 0.0 ? 1.0 : 0.0;
+            double qty = std::fabs(trade);
+
+            // Same IB fixed model and operation order as FillEvent::calcCommission
+            // (exact for order sizes below 2^11, as NaivePortfolio uses)
+            double baseComm = std::max(FillEvent::minComm, FillEvent::commPerShare * qty);
+            double maxCost = (FillEvent::maxPercent / 100.0) * (qty * close[t]);
+            double c = std::min(baseComm, maxCost) * traded;
+
+            // close * trade equals the fill's (direction * price) * quantity,
+            // and is +0.0 without a trade
+            comm[t] = c;
+            flow[t] = close[t] * trade + c;
+        }
+    }
+
+    // Sequential scan for cash, applying fills in symbol list order
+    std::vector<const double*> flows(numSymbols);
+    std::vector<const double*> comms(numSymbols);
+    for (size_t k = 0; k < numSymbols; k++) {
+        flows[k] = cashFlow[k].data();
+        comms[k] = commission[k].data();
+    }
+
+    const size_t rows = dates.empty() ? 0 : T;
+    result.datetime = dates;
+    result.cash.resize(rows);
+    result.commission.resize(rows);
+
+    double cash = initialCapital;
+    double totalComm = 0.0;
+
+    for (size_t t = 0; t < rows; t++) {
+        result.cash[t] = cash;
+        result.commission[t] = totalComm;
+
+        for (size_t k = 0; k < numSymbols; k++) {
+            cash -= flows[k][t];
+            totalComm += comms[k][t];
+        }
+    }
+
+    // Totals add market values in symbol list order, like updateTimeIndex
+    result.total = result.cash;
+    for (size_t k = 0; k < numSymbols; k++) {
+        const double* mv = marketValue[k].data();
+        double* total = result.total.data();
+
+        for (size_t t = 0; t < rows; t++) {
+            total[t] += mv[t];
+        }
+    }
+
+    for (size_t k = 0; k < numSymbols; k++) {
+        positionBefore[k].resize(rows);
+        marketValue[k].resize(rows);
+        result.positions[symbolList[k]] = std::move(positionBefore[k]);
+        result.holdings[symbolList[k]] = std::move(marketValue[k]);
+    }
+
+    return result;
+}
+
+SignalFunctionStrategy::SignalFunctionStrategy(DataHandler* data,
+                                               std::queue<std::shared_ptr<Event>>& events,
+                                               std::vector<std::string> symbolList,
+                                               SignalFunction signal)
+    : data(data), events(events), symbolList(symbolList), signal(signal) {
+    for (const auto& s : symbolList) {
+        lastTarget[s] = 0;
+    }
+}
+
+void SignalFunctionStrategy::calculateSignals() {
+    for (const auto& s : symbolList) {
+        std::vector<Bar> bars = data->getLatestBars(s, std::numeric_limits<int>::max());
+
+        if (bars.empty()) {
+            continue;
+        }
+
+        std::vector<int> target;
+        signal(toColumns(bars), target);
+
+        int latest = target.size() == bars.size() ? targetSign(target.back()) : 0;
+        if (latest == lastTarget[s]) {
+            continue;
+        }
+        lastTarget[s] = latest;
+
+        SignalType type = latest > 0 ? SignalType::LONG
+                        : latest < 0 ? SignalType::SHORT
+                        : SignalType::EXIT;
+
+        events.push(std::make_shared<SignalEvent>(s, bars.back().date, type));
+    }
+}
+
+bool verifyAgainstEventDriven(const std::string& csvDir, const std::vector<std::string>& symbolList,
+                              SignalFunction signal, double initialCapital) {
+    std::queue<std::shared_ptr<Event>> events;
+    HistoricCSVDataHandler data(events, csvDir, symbolList);
+
+    // Event-driven replay as a single pipeline
+    MultiStrategyEngine engine(&data, events);
+    MultiStrategyEngine::Pipeline& pipeline = engine.attach(
+        "event-driven",
+        [&signal](DataHandler* d, std::queue<std::shared_ptr<Event>>& q, std::vector<std::string> symbols) {
+            return std::make_unique<SignalFunctionStrategy>(d, q, symbols, signal);
+        },
+        initialCapital);
+    engine.run();
+
+    VectorizedResult vec = VectorizedBacktest(data, symbolList, signal, initialCapital).run();
+
+    // Row 0 of the portfolio history is the initial state, not a bar
+    const auto& allPositions = pipeline.portfolio->getAllPositions();
+    const auto& allHoldings = pipeline.portfolio->getAllHoldings();
+
+    if (allHoldings.size() != vec.total.size() + 1) {
+        std::cerr << "Row count mismatch: event-driven " << allHoldings.size() - 1
+                  << ", vectorised " << vec.total.size() << std::endl;
+        return false;
+    }
+
+    bool identical = true;
+    for (size_t t = 0; t < vec.total.size(); t++) {
+        const auto& dh = allHoldings[t + 1];
+        const auto& dp = allPositions[t + 1];
+
+        bool rowMatch = dh.at("cash") == vec.cash[t] && dh.at("commission") == vec.commission[t] &&
+                        dh.at("total") == vec.total[t];
+
+        for (const auto& s : symbolList) {
+            rowMatch = rowMatch && dh.at(s) == vec.holdings[s][t] && dp.at(s) == vec.positions[s][t];
+        }
+
+        if (!rowMatch) {
+            std::cerr << "Mismatch at bar " << vec.datetime[t] << ": total "
+                      << dh.at("total") << " vs " << vec.total[t] << std::endl;
+            identical = false;
+        }
+    }
+
+    return identical;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+#include <queue>
+#include <memory>
+#include <functional>
+#include <ctime>
+
+#include "event.h"
+#include "data_handler.h"
+#include "strategy.h"
+
+// One symbol's aligned history as columns
+struct BarColumns {
+    std::vector<time_t> date;
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> adjClose;
+    std::vector<long> vol;
+};
+
+/*
+Fills target (same length as the columns) with the desired position
+per bar: +1 long, -1 short, 0 flat (only the sign is used). Must be causal, i.e. target[t]
+may only depend on bars 0..t, so the event-driven engine sees the
+same signals when it replays the history bar by bar.
+*/
+using SignalFunction = std::function<void(const BarColumns& bars, std::vector<int>& target)>;
+
+// Long while the short moving average of close is above the long one
+SignalFunction movingAverageCross(size_t shortWindow, size_t longWindow);
+
+struct VectorizedResult {
+    /*
+    One row per bar, matching the rows NaivePortfolio::updateTimeIndex
+    records: positions and market values before that bar's fills.
+    */
+    std::vector<time_t> datetime;
+    std::map<std::string, std::vector<long>> positions;
+    std::map<std::string, std::vector<double>> holdings;
+    std::vector<double> cash;
+    std::vector<double> commission;
+    std::vector<double> total;
+};
+
+class VectorizedBacktest {
+    /*
+    VectorizedBacktest runs a strategy that is a pure function of bar
+    history over the whole aligned dataset at once, without events.
+
+    Market values, trades, commissions and totals are branch-free
+    loops over one symbol's double columns at a time, which GCC
+    vectorises at -O3. Only the signal function, the position state
+    machine (mirroring NaivePortfolio's sizing rules) and the running
+    cash balance are sequential scans. Orders fill at the close with
+    the same IB fixed commission as FillEvent, so results match the
+    event-driven engine row for row.
+    */
+
+public:
+    /*
+    Parameters:
+    data - A loaded HistoricCSVDataHandler (only its full history is read).
+    symbolList - The symbols to trade, in the order fills are applied.
+    signal - The strategy as a SignalFunction.
+    initialCapital - The starting capital in USD.
+    */
+    VectorizedBacktest(const HistoricCSVDataHandler& data, std::vector<std::string> symbolList,
+                       SignalFunction signal, double initialCapital = 100000.0);
+
+    VectorizedResult run() const;
+
+private:
+    const HistoricCSVDataHandler& data;
+    std::vector<std::string> symbolList;
+    SignalFunction signal;
+    double initialCapital;
+};
+
+class SignalFunctionStrategy : public Strategy {
+    /*
+    Wraps a SignalFunction as an event-driven Strategy. Every bar it
+    evaluates the function on the history seen so far and emits a
+    LONG, SHORT or EXIT signal whenever the target position changes.
+    This recomputes the whole history each bar, so it is only meant
+    for checking the vectorised engine against the event loop.
+    */
+
+public:
+    SignalFunctionStrategy(DataHandler* data,
+                           std::queue<std::shared_ptr<Event>>& events,
+                           std::vector<std::string> symbolList,
+                           SignalFunction signal);
+
+    void calculateSignals() override;
+
+private:
+    DataHandler* data;
+    std::queue<std::shared_ptr<Event>>& events;
+    std::vector<std::string> symbolList;
+    SignalFunction signal;
+    std::map<std::string, int> lastTarget;
+};
+
+/*
+Replays the signal function through the event-driven engine (a
+MultiStrategyEngine pipeline of SignalFunctionStrategy, NaivePortfolio
+and IntrabarExecutionHandler) and compares every recorded row with
+VectorizedBacktest. Mismatches are reported on std::cerr.
+Returns true if all rows are identical.
+*/
+bool verifyAgainstEventDriven(const std::string& csvDir, const std::vector<std::string>& symbolList,
+                              SignalFunction signal, double initialCapital = 100000.0);